@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "scheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Counts the system allocations of the whole benchmark binary.
+std::atomic<std::size_t> allocations{0};
+
+struct BenchController : public IController {};
+struct BenchUserData : public IUserData {};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size != 0 ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+void operator delete(void* memory, std::size_t /*size*/) noexcept {
+  std::free(memory);
+}
+
+/// Create, push, fire and erase an event per iteration and report the system allocations per iteration.
+void BM_EventChurn(benchmark::State& state) {
+  Scheduler::Config config;
+  config.eventStorage = state.range(0) == 0 ? Scheduler::EventStorage::Heap : Scheduler::EventStorage::Slab;
+  state.SetLabel(state.range(0) == 0 ? "heap" : "slab");
+  Scheduler scheduler(config);
+  scheduler.reserve(1024);
+  auto controller = std::make_shared<BenchController>();
+  auto userData = std::make_shared<BenchUserData>();
+  auto noop = [](const EventPtr&) {};
+  const EventConfig eventConfig{0ms, 1h, 2h, noop, noop, noop, noop, noop};
+  // warm up the slot tables and vectors
+  for (int i = 0; i < 1024; ++i) {
+    scheduler.eraseEvent(scheduler.pushEvent(controller, userData, eventConfig));
+  }
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+
+  const auto before = allocations.load(std::memory_order_relaxed);
+  for (auto _ : state) {
+    auto event = scheduler.pushEvent(controller, userData, eventConfig);
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+    scheduler.eraseEvent(event);
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+  state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations.load(std::memory_order_relaxed) - before), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_EventChurn)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
@@ -0,0 +1,215 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "scheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Sizes of the core benchmarks, events in the scheduler
+constexpr std::int64_t kMinEvents{1000};
+constexpr std::int64_t kMaxEvents{1000000};
+/// User data the events of the erase by user data benchmark are spread over
+constexpr std::size_t kUserDataGroups{16};
+/// Events every producer thread cycles through
+constexpr std::size_t kProducerEvents{64};
+
+struct BenchController : public IController {};
+struct BenchUserData : public IUserData {};
+
+/// Events whose start is an hour away, a pass only applies their push.
+std::vector<EventPtr> makeDormant(std::size_t count, const std::vector<std::shared_ptr<BenchUserData>>& userData) {
+  auto controller = std::make_shared<BenchController>();
+  auto noop = [](EventPtr) {};
+  const EventConfig config{1h, 1h, 2h, noop, noop, noop, noop, noop};
+  std::vector<EventPtr> events;
+  events.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    events.push_back(std::make_shared<Event>(controller, userData[i % userData.size()], config));
+  }
+  return events;
+}
+
+/// Scheduler holding the given events, pushed and applied.
+std::unique_ptr<Scheduler> makeFilled(const std::vector<EventPtr>& events) {
+  auto scheduler = std::make_unique<Scheduler>();
+  scheduler->reserve(events.size());
+  for (const auto& event : events) {
+    (void)scheduler->pushEvent(event);
+  }
+  (void)scheduler->processEvents(Scheduler::kMaxDelayIntervalMs);
+  return scheduler;
+}
+
+/// Scheduler shared by the producer threads, its thread applies the submitted pushes.
+std::unique_ptr<Scheduler> producerScheduler;
+
+}  // namespace
+
+/// Pushes N events into an empty scheduler and applies them in one pass, reported per event.
+void BM_CorePush(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const std::vector userData{std::make_shared<BenchUserData>()};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto events = makeDormant(count, userData);
+    auto scheduler = std::make_unique<Scheduler>();
+    state.ResumeTiming();
+    for (const auto& event : events) {
+      (void)scheduler->pushEvent(event);
+    }
+    benchmark::DoNotOptimize(scheduler->processEvents(Scheduler::kMaxDelayIntervalMs));
+    state.PauseTiming();
+    scheduler.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CorePush)->RangeMultiplier(10)->Range(kMinEvents, kMaxEvents)->Unit(benchmark::kMillisecond);
+
+/// Pushes N events as one batch into an empty scheduler and applies them in one pass, reported per event.
+void BM_CorePushBatch(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const std::vector userData{std::make_shared<BenchUserData>()};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto events = makeDormant(count, userData);
+    auto scheduler = std::make_unique<Scheduler>();
+    state.ResumeTiming();
+    (void)scheduler->pushEvents(events);
+    benchmark::DoNotOptimize(scheduler->processEvents(Scheduler::kMaxDelayIntervalMs));
+    state.PauseTiming();
+    scheduler.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CorePushBatch)->RangeMultiplier(10)->Range(kMinEvents, kMaxEvents)->Unit(benchmark::kMillisecond);
+
+/// Erases all N events of a scheduler one by one and applies the erases in one pass, reported per event.
+void BM_CoreEraseEvent(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const std::vector userData{std::make_shared<BenchUserData>()};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto events = makeDormant(count, userData);
+    auto scheduler = makeFilled(events);
+    state.ResumeTiming();
+    for (const auto& event : events) {
+      scheduler->eraseEvent(event);
+    }
+    benchmark::DoNotOptimize(scheduler->processEvents(Scheduler::kMaxDelayIntervalMs));
+    state.PauseTiming();
+    scheduler.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CoreEraseEvent)->RangeMultiplier(10)->Range(kMinEvents, kMaxEvents)->Unit(benchmark::kMillisecond);
+
+/// Erases all N events of a scheduler as one batch and applies the erases in one pass, reported per event.
+void BM_CoreEraseBatch(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const std::vector userData{std::make_shared<BenchUserData>()};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto events = makeDormant(count, userData);
+    auto scheduler = makeFilled(events);
+    state.ResumeTiming();
+    scheduler->eraseEvents(events);
+    benchmark::DoNotOptimize(scheduler->processEvents(Scheduler::kMaxDelayIntervalMs));
+    state.PauseTiming();
+    scheduler.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CoreEraseBatch)->RangeMultiplier(10)->Range(kMinEvents, kMaxEvents)->Unit(benchmark::kMillisecond);
+
+/// Erases N events by their 16 user data and applies the erases in one pass, reported per erase.
+void BM_CoreEraseUserData(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  std::vector<std::shared_ptr<BenchUserData>> userData;
+  for (std::size_t i = 0; i < kUserDataGroups; ++i) {
+    userData.push_back(std::make_shared<BenchUserData>());
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto scheduler = makeFilled(makeDormant(count, userData));
+    state.ResumeTiming();
+    for (const auto& data : userData) {
+      scheduler->eraseEvent(data);
+    }
+    benchmark::DoNotOptimize(scheduler->processEvents(Scheduler::kMaxDelayIntervalMs));
+    state.PauseTiming();
+    scheduler.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kUserDataGroups));
+}
+BENCHMARK(BM_CoreEraseUserData)->RangeMultiplier(10)->Range(kMinEvents, kMaxEvents)->Unit(benchmark::kMillisecond);
+
+/// One pass over N events of which none is due.
+void BM_CoreIdlePass(benchmark::State& state) {
+  const std::vector userData{std::make_shared<BenchUserData>()};
+  const auto events = makeDormant(static_cast<std::size_t>(state.range(0)), userData);
+  auto scheduler = makeFilled(events);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scheduler->processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+}
+BENCHMARK(BM_CoreIdlePass)->RangeMultiplier(10)->Range(kMinEvents, kMaxEvents)->Unit(benchmark::kNanosecond);
+
+/// One pass in which all N events fire: pop, serve callback, re-arm, reported per event.
+void BM_CoreFireCycle(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  auto controller = std::make_shared<BenchController>();
+  auto userData = std::make_shared<BenchUserData>();
+  auto noop = [](EventPtr) {};
+  // due again on every pass
+  const EventConfig config{0ms, 1ns, Event::kDefaultEndlessLifeMs, noop, noop, noop, noop, noop};
+  Scheduler scheduler;
+  scheduler.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    (void)scheduler.pushEvent(controller, userData, config);
+  }
+  // the first pass runs the start callbacks
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CoreFireCycle)->RangeMultiplier(10)->Range(kMinEvents, kMaxEvents)->Unit(benchmark::kMillisecond);
+
+/// Pushes from 1 to 8 producer threads into a running scheduler holding N events, reported per push.
+void BM_CoreProducers(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    producerScheduler = makeFilled(makeDormant(static_cast<std::size_t>(state.range(0)),
+                                               std::vector{std::make_shared<BenchUserData>()}));
+    (void)producerScheduler->start();
+  }
+  // a push of an event still queued restarts it, the queue keeps its size
+  const auto events = makeDormant(kProducerEvents, std::vector{std::make_shared<BenchUserData>()});
+  std::size_t next = 0;
+  for (auto _ : state) {
+    (void)producerScheduler->pushEvent(events[next]);
+    next = (next + 1) % kProducerEvents;
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    producerScheduler.reset();
+  }
+}
+BENCHMARK(BM_CoreProducers)
+    ->RangeMultiplier(10)
+    ->Range(kMinEvents, kMaxEvents)
+    ->ThreadRange(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kNanosecond);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+
+#include "scheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::size_t kOutstandingTimers{1000000};
+
+struct BenchController : public IController {};
+struct BenchUserData : public IUserData {};
+
+EventConfig makeTimeoutConfig(DurationUnit life) {
+  auto noop = [](EventPtr) {};
+  return EventConfig{0ms, 1h, life, noop, noop, noop, noop, noop};
+}
+
+Scheduler::QueueMode queueMode(const benchmark::State& state) {
+  return state.range(0) == 0 ? Scheduler::QueueMode::Heap : Scheduler::QueueMode::TimingWheel;
+}
+
+/// Fills the scheduler with connection-style timeouts between 10 seconds and 5 minutes.
+void fillTimeouts(Scheduler& scheduler, benchmark::State& state) {
+  state.SetLabel(state.range(0) == 0 ? "heap" : "wheel");
+  auto controller = std::make_shared<BenchController>();
+  auto userData = std::make_shared<BenchUserData>();
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> lifeMs(10000, 300000);
+  for (std::size_t i = 0; i < kOutstandingTimers; ++i) {
+    (void)scheduler.pushEvent(controller, userData, makeTimeoutConfig(std::chrono::milliseconds(lifeMs(rng))));
+  }
+  // the first pass runs the start callbacks
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+}
+
+}  // namespace
+
+/// Arm and cancel one timeout while 1M timeouts are outstanding, including the pass applying both.
+void BM_ArmCancelAt1M(benchmark::State& state) {
+  Scheduler scheduler(queueMode(state));
+  fillTimeouts(scheduler, state);
+  auto event = std::make_shared<Event>(std::make_shared<BenchController>(), std::make_shared<BenchUserData>(),
+                                       makeTimeoutConfig(30s));
+  for (auto _ : state) {
+    scheduler.pushEvent(event);
+    scheduler.eraseEvent(event);
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+}
+BENCHMARK(BM_ArmCancelAt1M)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+/// Arm a request timeout and cancel it by handle before it fires while 1M timeouts are outstanding.
+void BM_CancelByHandleAt1M(benchmark::State& state) {
+  Scheduler scheduler(queueMode(state));
+  fillTimeouts(scheduler, state);
+  auto event = std::make_shared<Event>(std::make_shared<BenchController>(), std::make_shared<BenchUserData>(),
+                                       makeTimeoutConfig(30s));
+  for (auto _ : state) {
+    const auto handle = scheduler.pushEvent(event);
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    scheduler.cancelEvent(handle);
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+}
+BENCHMARK(BM_CancelByHandleAt1M)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+/// Re-arm an outstanding timeout, as done on every request of an idle connection, including the pass applying it.
+void BM_RearmAt1M(benchmark::State& state) {
+  Scheduler scheduler(queueMode(state));
+  fillTimeouts(scheduler, state);
+  auto event = scheduler.pushEvent(std::make_shared<BenchController>(), std::make_shared<BenchUserData>(),
+                                   makeTimeoutConfig(30s));
+  for (auto _ : state) {
+    scheduler.pushEvent(event);
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+}
+BENCHMARK(BM_RearmAt1M)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+/// Processing pass while 1M timeouts are outstanding and none is due.
+void BM_IdleTickAt1M(benchmark::State& state) {
+  Scheduler scheduler(queueMode(state));
+  fillTimeouts(scheduler, state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+}
+BENCHMARK(BM_IdleTickAt1M)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
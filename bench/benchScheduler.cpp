@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+#include "scheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct BenchController : public IController {};
+struct BenchUserData : public IUserData {};
+
+EventConfig makeConfig(DurationUnit serve, DurationUnit life) {
+  auto noop = [](EventPtr) {};
+  return EventConfig{0ms, serve, life, noop, noop, noop, noop, noop};
+}
+
+/// Fills the scheduler with events which are started but not due for a long time.
+void fillIdle(Scheduler& scheduler, std::size_t count) {
+  auto controller = std::make_shared<BenchController>();
+  auto userData = std::make_shared<BenchUserData>();
+  const auto config = makeConfig(1h, 2h);
+  for (std::size_t i = 0; i < count; ++i) {
+    (void)scheduler.pushEvent(controller, userData, config);
+  }
+  // the first pass runs the start callbacks
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+}
+
+}  // namespace
+
+/// Tick cost when none of the registered events is due.
+void BM_ProcessEventsIdle(benchmark::State& state) {
+  Scheduler scheduler;
+  fillIdle(scheduler, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ProcessEventsIdle)->RangeMultiplier(10)->Range(1000, 100000)->Complexity();
+
+/// Tick cost when exactly one of the registered events is due on every pass.
+void BM_ProcessEventsOneDue(benchmark::State& state) {
+  Scheduler scheduler;
+  fillIdle(scheduler, static_cast<std::size_t>(state.range(0)));
+  (void)scheduler.pushEvent(std::make_shared<BenchController>(), std::make_shared<BenchUserData>(),
+                            makeConfig(0ms, Event::kDefaultEndlessLifeMs));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs));
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ProcessEventsOneDue)->RangeMultiplier(10)->Range(1000, 100000)->Complexity();
+
+/// Replays one virtual second of N events with a period of 1 s on a manual clock, reported per served event.
+void BM_VirtualTimeReplay(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  auto clock = std::make_shared<ManualClock>();
+  Scheduler::Config config;
+  config.clock = clock;
+  Scheduler scheduler(config);
+  scheduler.reserve(count);
+  auto controller = std::make_shared<BenchController>();
+  auto userData = std::make_shared<BenchUserData>();
+  auto noop = [](EventPtr) {};
+  for (std::size_t i = 0; i < count; ++i) {
+    // phases spread over the period, every pass serves a few events
+    const DurationUnit phase{static_cast<DurationUnit::rep>(i) * DurationUnit{1s}.count() /
+                             static_cast<DurationUnit::rep>(count)};
+    (void)scheduler.pushEvent(controller, userData,
+                              EventConfig{phase + 1ns, 1s, Event::kDefaultEndlessLifeMs, noop, noop, noop, noop, noop});
+  }
+  for (auto _ : state) {
+    const auto until = clock->now() + 1s;
+    while (clock->now() < until) {
+      clock->advance(scheduler.processEvents(1s));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VirtualTimeReplay)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/// One read of the clock a scheduler runs on: 0 steady_clock, 1 CLOCK_MONOTONIC_COARSE, 2 time stamp counter.
+/// The threads of a run share the clock, as the scheduler thread and the workers do.
+void BM_ClockNow(benchmark::State& state) {
+  static const std::array<std::shared_ptr<IClock>, 3> clocks{SteadyClock::instance(), std::make_shared<CoarseClock>(),
+                                                             TscClock::create()};
+  const auto& clock = clocks[static_cast<std::size_t>(state.range(0))];
+  if (!clock) {
+    state.SkipWithError("no invariant time stamp counter");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(clock->now());
+  }
+}
+BENCHMARK(BM_ClockNow)->ArgName("clock")->DenseRange(0, 2)->ThreadRange(1, 4);
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "shardedScheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr int kTimers{100000};
+constexpr int kUserData{256};
+
+struct BenchController : public IController {};
+
+/// Served callbacks of the events of one user data, only written by the shard owning them.
+struct alignas(64) BenchUserData : public IUserData {
+  std::atomic<std::uint64_t> served{0};
+};
+
+std::uint64_t servedSum(const std::vector<std::shared_ptr<BenchUserData>>& userData) {
+  std::uint64_t served = 0;
+  for (const auto& data : userData) {
+    served += data->served.load(std::memory_order_relaxed);
+  }
+  return served;
+}
+
+}  // namespace
+
+/// Serves 100000 timers with a period of 1 ms on 1 to 16 pinned shards and reports the served timers per second.
+void BM_ShardedTimerThroughput(benchmark::State& state) {
+  ShardedScheduler::Config config;
+  config.shards = static_cast<std::size_t>(state.range(0));
+  config.placement = ShardedScheduler::Placement::UserData;
+  for (unsigned cpu = 0; cpu < std::max(1U, std::thread::hardware_concurrency()); ++cpu) {
+    config.cpus.push_back(static_cast<int>(cpu));
+  }
+  ShardedScheduler scheduler(config);
+  scheduler.reserve(kTimers);
+
+  auto controller = std::make_shared<BenchController>();
+  std::vector<std::shared_ptr<BenchUserData>> userData;
+  for (int i = 0; i < kUserData; ++i) {
+    userData.push_back(std::make_shared<BenchUserData>());
+  }
+  auto onServe = [](const EventPtr& event) {
+    static_cast<BenchUserData&>(*event->getUserData()).served.fetch_add(1, std::memory_order_relaxed);
+  };
+  const EventConfig eventConfig{0ms, 1ms, Event::kDefaultEndlessLifeMs, nullptr, onServe, nullptr, nullptr, nullptr};
+  for (int i = 0; i < kTimers; ++i) {
+    (void)scheduler.pushEvent(controller, userData[static_cast<std::size_t>(i % kUserData)], eventConfig);
+  }
+  if (!scheduler.start()) {
+    state.SkipWithError("shards did not start");
+    return;
+  }
+  std::this_thread::sleep_for(50ms);
+
+  const auto firstServed = servedSum(userData);
+  for (auto _ : state) {
+    std::this_thread::sleep_for(100ms);
+  }
+  state.counters["timers_per_s"] =
+      benchmark::Counter(static_cast<double>(servedSum(userData) - firstServed), benchmark::Counter::kIsRate);
+  scheduler.terminate();
+}
+BENCHMARK(BM_ShardedTimerThroughput)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Iterations(5)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
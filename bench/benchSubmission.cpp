@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+
+#include "scheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct BenchController : public IController {};
+struct BenchUserData : public IUserData {};
+
+/// Scheduler shared by the benchmark threads, its thread applies the submitted commands.
+std::unique_ptr<Scheduler> sharedScheduler;
+
+}  // namespace
+
+/// Push and erase one event per iteration from 1 to 32 producer threads while the scheduler thread runs.
+void BM_PushEraseContention(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    sharedScheduler = std::make_unique<Scheduler>();
+    (void)sharedScheduler->start();
+  }
+  auto noop = [](EventPtr) {};
+  auto event = std::make_shared<Event>(std::make_shared<BenchController>(), std::make_shared<BenchUserData>(),
+                                       EventConfig{0ms, 1h, 2h, noop, noop, noop, noop, noop});
+  for (auto _ : state) {
+    sharedScheduler->pushEvent(event);
+    sharedScheduler->eraseEvent(event);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+  if (state.thread_index() == 0) {
+    sharedScheduler.reset();
+  }
+}
+BENCHMARK(BM_PushEraseContention)->ThreadRange(1, 32)->UseRealTime()->Unit(benchmark::kNanosecond);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "scheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr int kPeriodicEvents{200};
+
+struct BenchController : public IController {};
+struct BenchUserData : public IUserData {};
+
+}  // namespace
+
+/// Serves periodic events with periods between 10 and 20 ms and reports how often the scheduler thread wakes up
+/// for a given slack in microseconds.
+void BM_CoalescedWakeups(benchmark::State& state) {
+  std::atomic<std::uint64_t> served{0};
+  Scheduler scheduler;
+  auto controller = std::make_shared<BenchController>();
+  auto userData = std::make_shared<BenchUserData>();
+  auto onServe = [&served](const EventPtr&) {
+    served.fetch_add(1, std::memory_order_relaxed);
+  };
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> periodUs(10000, 20000);
+  for (int i = 0; i < kPeriodicEvents; ++i) {
+    const DurationUnit period = std::chrono::microseconds(periodUs(rng));
+    EventConfig config{0ms, period, Event::kDefaultEndlessLifeMs, nullptr, onServe, nullptr, nullptr, nullptr};
+    config.slack = std::chrono::microseconds(state.range(0));
+    (void)scheduler.pushEvent(controller, userData, config);
+  }
+  if (!scheduler.start()) {
+    state.SkipWithError("scheduler did not start");
+    return;
+  }
+  std::this_thread::sleep_for(50ms);
+
+  const auto firstPass = scheduler.getPassCount();
+  const auto firstServed = served.load();
+  for (auto _ : state) {
+    std::this_thread::sleep_for(100ms);
+  }
+  state.counters["wakeups_per_s"] =
+      benchmark::Counter(static_cast<double>(scheduler.getPassCount() - firstPass), benchmark::Counter::kIsRate);
+  state.counters["served_per_s"] =
+      benchmark::Counter(static_cast<double>(served.load() - firstServed), benchmark::Counter::kIsRate);
+  scheduler.terminate();
+}
+BENCHMARK(BM_CoalescedWakeups)
+    ->Arg(0)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Iterations(5)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
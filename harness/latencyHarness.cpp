@@ -0,0 +1,330 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  End-to-end timer accuracy harness: drives a scheduler with periodic events under load and
+ * reports the firing lateness per configuration.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "scheduler.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct HarnessController : public IController {};
+struct HarnessUserData : public IUserData {};
+
+/// How the periods of the events are drawn
+enum class Distribution {
+  Fixed,      ///< every event has the minimum period
+  Uniform,    ///< uniform between minimum and maximum period
+  LogUniform  ///< uniform in the logarithm, as many short as long timers
+};
+
+/// Command line of the harness, lists run every combination
+struct Options {
+  std::vector<std::size_t> events{100, 1000, 10000};                         ///< Events per run
+  std::vector<DurationUnit> costs{0us};                                      ///< Busy time of every serve callback
+  std::vector<std::size_t> loads{0};                                         ///< Threads spinning in the background
+  Distribution distribution{Distribution::LogUniform};                       ///< Distribution of the periods
+  DurationUnit minPeriod{1ms};                                               ///< Shortest period
+  DurationUnit maxPeriod{100ms};                                             ///< Longest period
+  DurationUnit duration{5s};                                                 ///< Measured time per run
+  DurationUnit budget{1ms};                                                  ///< Lateness of a missed deadline
+  Scheduler::WaitStrategy waitStrategy{Scheduler::WaitStrategy::Sleep};      ///< Wait of the scheduler thread
+  Scheduler::ExecutionMode executionMode{Scheduler::ExecutionMode::Inline};  ///< Threads running the callbacks
+  std::shared_ptr<IClock> clock{};                                           ///< Time source, steady_clock if empty
+  int cpu{-1};                                                               ///< CPU of the scheduler thread
+  std::uint64_t seed{1};                                                     ///< Seed of the periods and phases
+  bool csv{false};                                                           ///< CSV instead of a table
+};
+
+/// Result of one run
+struct RunResult {
+  LatencyHistogram::Snapshot lateness;  ///< Lateness of the serve callbacks
+  std::uint64_t missedDeadlines{0};     ///< Callbacks later than the budget
+  std::uint64_t missedPeriods{0};       ///< Periods dropped by the catch-up policy
+};
+
+void printUsage() {
+  std::cout << "usage: latency_harness [options]\n"
+               "  --events=N[,N...]         events per run (100,1000,10000)\n"
+               "  --cost-us=N[,N...]        busy time of every callback in us (0)\n"
+               "  --load=N[,N...]           background threads spinning on other CPUs (0)\n"
+               "  --periods=fixed|uniform|loguniform   period distribution (loguniform)\n"
+               "  --min-period-us=N         shortest period (1000)\n"
+               "  --max-period-us=N         longest period (100000)\n"
+               "  --duration-s=N            measured time per run (5)\n"
+               "  --budget-us=N             lateness counted as a missed deadline (1000)\n"
+               "  --wait=sleep|sleepuntil|spin|busy|iouring   wait strategy (sleep)\n"
+               "  --execution=inline|pool   where the callbacks run (inline)\n"
+               "  --clock=steady|coarse|tsc time source of the scheduler (steady)\n"
+               "  --cpu=N                   pin the scheduler thread (none)\n"
+               "  --seed=N                  seed of the periods and phases (1)\n"
+               "  --csv                     print CSV instead of a table\n";
+}
+
+template <class T>
+std::vector<T> parseList(std::string_view text) {
+  std::vector<T> values;
+  std::istringstream in{std::string(text)};
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    values.push_back(static_cast<T>(std::stoull(item)));
+  }
+  return values;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    const auto separator = arg.find('=');
+    const auto key = arg.substr(0, separator);
+    const auto value = separator != std::string_view::npos ? arg.substr(separator + 1) : std::string_view{};
+    const auto micros = [&]() {
+      return DurationUnit{std::chrono::microseconds(std::stoll(std::string(value)))};
+    };
+    if (key == "--events") {
+      options.events = parseList<std::size_t>(value);
+    } else if (key == "--cost-us") {
+      options.costs.clear();
+      for (const auto cost : parseList<std::int64_t>(value)) {
+        options.costs.emplace_back(std::chrono::microseconds(cost));
+      }
+    } else if (key == "--load") {
+      options.loads = parseList<std::size_t>(value);
+    } else if (key == "--periods" && value == "fixed") {
+      options.distribution = Distribution::Fixed;
+    } else if (key == "--periods" && value == "uniform") {
+      options.distribution = Distribution::Uniform;
+    } else if (key == "--periods" && value == "loguniform") {
+      options.distribution = Distribution::LogUniform;
+    } else if (key == "--min-period-us") {
+      options.minPeriod = micros();
+    } else if (key == "--max-period-us") {
+      options.maxPeriod = micros();
+    } else if (key == "--duration-s") {
+      options.duration = std::chrono::seconds(std::stoll(std::string(value)));
+    } else if (key == "--budget-us") {
+      options.budget = micros();
+    } else if (key == "--wait" && value == "sleep") {
+      options.waitStrategy = Scheduler::WaitStrategy::Sleep;
+    } else if (key == "--wait" && value == "sleepuntil") {
+      options.waitStrategy = Scheduler::WaitStrategy::SleepUntil;
+    } else if (key == "--wait" && value == "spin") {
+      options.waitStrategy = Scheduler::WaitStrategy::SleepThenSpin;
+    } else if (key == "--wait" && value == "busy") {
+      options.waitStrategy = Scheduler::WaitStrategy::BusyPoll;
+    } else if (key == "--wait" && value == "iouring") {
+      options.waitStrategy = Scheduler::WaitStrategy::IoUring;
+    } else if (key == "--execution" && value == "inline") {
+      options.executionMode = Scheduler::ExecutionMode::Inline;
+    } else if (key == "--execution" && value == "pool") {
+      options.executionMode = Scheduler::ExecutionMode::Pool;
+    } else if (key == "--clock" && value == "steady") {
+      options.clock = SteadyClock::instance();
+    } else if (key == "--clock" && value == "coarse") {
+      options.clock = std::make_shared<CoarseClock>();
+    } else if (key == "--clock" && value == "tsc") {
+      options.clock = TscClock::create();
+      if (!options.clock) {
+        std::cerr << "no invariant time stamp counter\n";
+        return false;
+      }
+    } else if (key == "--cpu") {
+      options.cpu = std::stoi(std::string(value));
+    } else if (key == "--seed") {
+      options.seed = std::stoull(std::string(value));
+    } else if (key == "--csv") {
+      options.csv = true;
+    } else {
+      return false;
+    }
+  }
+  return !options.events.empty() && !options.costs.empty() && !options.loads.empty() &&
+         options.minPeriod > DurationUnit{0} && options.minPeriod <= options.maxPeriod;
+}
+
+DurationUnit drawPeriod(const Options& options, std::mt19937_64& random) {
+  const auto min = static_cast<double>(options.minPeriod.count());
+  const auto max = static_cast<double>(options.maxPeriod.count());
+  switch (options.distribution) {
+    case Distribution::Fixed:
+      return options.minPeriod;
+    case Distribution::Uniform:
+      return DurationUnit{static_cast<DurationUnit::rep>(std::uniform_real_distribution<double>(min, max)(random))};
+    case Distribution::LogUniform:
+      break;
+  }
+  const auto exponent = std::uniform_real_distribution<double>(std::log(min), std::log(max))(random);
+  return DurationUnit{static_cast<DurationUnit::rep>(std::exp(exponent))};
+}
+
+/// Busy-waits instead of sleeping, like a callback doing work
+void burn(DurationUnit cost) {
+  const auto until = std::chrono::steady_clock::now() + cost;
+  while (std::chrono::steady_clock::now() < until) {
+  }
+}
+
+/**
+ * @brief Threads competing for the CPUs and caches, pinned to every CPU except the scheduler's.
+ */
+class BackgroundLoad {
+ public:
+  BackgroundLoad(std::size_t threads, int avoidCpu) {
+    const auto cpus = std::max(1U, std::thread::hardware_concurrency());
+    for (std::size_t i = 0; i < threads; ++i) {
+      m_Threads.emplace_back([](const std::stop_token& stopToken) {
+        // walks a buffer larger than most L2 caches
+        std::vector<std::uint64_t> buffer(1U << 20U, 1);
+        std::uint64_t state = 88172645463325252ULL;
+        while (!stopToken.stop_requested()) {
+          for (int step = 0; step < 4096; ++step) {
+            state ^= state << 13U;
+            state ^= state >> 7U;
+            state ^= state << 17U;
+            buffer[state & (buffer.size() - 1)] += state;
+          }
+        }
+      });
+#if defined(__linux__)
+      if (cpus > 1) {
+        auto cpu = static_cast<int>(i % (cpus - 1));
+        cpu += avoidCpu >= 0 && cpu >= avoidCpu ? 1 : 0;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(static_cast<std::size_t>(cpu), &set);
+        (void)pthread_setaffinity_np(m_Threads.back().native_handle(), sizeof(set), &set);
+      }
+#else
+      (void)avoidCpu;
+#endif
+    }
+  }
+
+ private:
+  std::vector<std::jthread> m_Threads;  ///< Stopped and joined on destruction
+};
+
+RunResult run(const Options& options, std::size_t events, DurationUnit cost, std::size_t load) {
+  Scheduler::Config config;
+  config.waitStrategy = options.waitStrategy;
+  config.executionMode = options.executionMode;
+  config.cpu = options.cpu;
+  config.clock = options.clock;
+  Scheduler scheduler(config);
+  scheduler.reserve(events);
+
+  const BackgroundLoad background(load, options.cpu);
+  std::mt19937_64 random(options.seed);
+  auto controller = std::make_shared<HarnessController>();
+  auto userData = std::make_shared<HarnessUserData>();
+  auto serve = [cost](const EventPtr&) {
+    burn(cost);
+  };
+  for (std::size_t i = 0; i < events; ++i) {
+    const auto period = drawPeriod(options, random);
+    // random phases, otherwise all events with the same period fire in the same pass
+    const DurationUnit phase{std::uniform_int_distribution<DurationUnit::rep>(1, period.count())(random)};
+    (void)scheduler.pushEvent(controller, userData,
+                              EventConfig{phase, period, Event::kDefaultEndlessLifeMs, nullptr, serve, nullptr,
+                                          nullptr, nullptr});
+  }
+  if (!scheduler.start()) {
+    std::cerr << "cannot start the scheduler on CPU " << options.cpu << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+  std::this_thread::sleep_for(options.duration);
+  scheduler.terminate();
+
+  RunResult result;
+  result.lateness = scheduler.getLatencyHistograms().lateness.snapshot();
+  result.missedPeriods = scheduler.getMissedPeriods();
+  const auto budget = static_cast<std::uint64_t>(options.budget.count());
+  for (std::size_t bucket = 0; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+    // buckets are counted from their lowest value, within the precision of the histogram
+    if (LatencyHistogram::lowestValueOf(bucket) > budget) {
+      result.missedDeadlines += result.lateness.counts[bucket];
+    }
+  }
+  return result;
+}
+
+double micros(DurationUnit value) {
+  return std::chrono::duration<double, std::micro>(value).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  bool valid = false;
+  try {
+    valid = parseOptions(argc, argv, options);
+  } catch (const std::exception&) {
+    // a number which does not parse
+  }
+  if (!valid) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  if (options.csv) {
+    std::cout << "events,cost_us,load,callbacks,p50_us,p99_us,p999_us,max_us,missed_deadlines,missed_periods\n";
+  } else {
+    std::cout << "lateness of the callbacks in us, deadlines missed by more than " << micros(options.budget)
+              << " us\n"
+              << std::setw(8) << "events" << std::setw(9) << "cost" << std::setw(6) << "load" << std::setw(11)
+              << "callbacks" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(11) << "max" << std::setw(10) << "missed" << std::setw(10) << "periods" << "\n";
+  }
+  std::cout << std::fixed << std::setprecision(1);
+  for (const auto events : options.events) {
+    for (const auto cost : options.costs) {
+      for (const auto load : options.loads) {
+        const auto result = run(options, events, cost, load);
+        const auto& lateness = result.lateness;
+        if (options.csv) {
+          std::cout << events << ',' << micros(cost) << ',' << load << ',' << lateness.count << ','
+                    << micros(lateness.p50()) << ',' << micros(lateness.p99()) << ',' << micros(lateness.p999())
+                    << ',' << micros(lateness.max) << ',' << result.missedDeadlines << ',' << result.missedPeriods
+                    << "\n";
+        } else {
+          std::cout << std::setw(8) << events << std::setw(9) << micros(cost) << std::setw(6) << load
+                    << std::setw(11) << lateness.count << std::setw(10) << micros(lateness.p50()) << std::setw(10)
+                    << micros(lateness.p99()) << std::setw(10) << micros(lateness.p999()) << std::setw(11)
+                    << micros(lateness.max) << std::setw(10) << result.missedDeadlines << std::setw(10)
+                    << result.missedPeriods << "\n";
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
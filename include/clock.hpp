@@ -0,0 +1,234 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the clocks a scheduler reads its time from.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#if defined(__x86_64__) || defined(__i386__)
+#define TEV_HAS_TSC 1
+#include <x86intrin.h>
+#endif
+
+namespace tev {
+
+/**
+ * @brief Source of the current time of a scheduler.
+ *
+ * All deadlines of a scheduler and of its events are time points of its clock. The time points have
+ * the type of std::chrono::steady_clock, a clock which is not real time only shares the type.
+ */
+class IClock {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  virtual ~IClock() = default;
+
+  [[nodiscard]] virtual TimePoint now() const noexcept = 0;
+
+  /**
+   * @brief whether the time points are the ones of steady_clock
+   * @details Only then the scheduler thread can wait for a deadline, see Scheduler::start().
+   */
+  [[nodiscard]] virtual bool isRealTime() const noexcept = 0;
+};
+
+/**
+ * @brief std::chrono::steady_clock, the default clock.
+ */
+class SteadyClock : public IClock {
+ public:
+  [[nodiscard]] TimePoint now() const noexcept override {
+    return std::chrono::steady_clock::now();
+  }
+  [[nodiscard]] bool isRealTime() const noexcept override {
+    return true;
+  }
+
+  /**
+   * @brief clock shared by all schedulers without a clock of their own
+   */
+  [[nodiscard]] static const std::shared_ptr<SteadyClock>& instance() {
+    static const auto clock = std::make_shared<SteadyClock>();
+    return clock;
+  }
+};
+
+/**
+ * @brief CLOCK_MONOTONIC_COARSE, the monotonic time of the last kernel tick.
+ *
+ * A read costs a few nanoseconds since the vDSO only copies the time, but it moves in steps of
+ * resolution(), 1 to 4 ms depending on the kernel tick. The time is the one of steady_clock at the
+ * last tick, so deadlines are served up to a step late, more where ticks are delayed as in virtual
+ * machines. For periods well above a step.
+ */
+class CoarseClock : public IClock {
+ public:
+  [[nodiscard]] TimePoint now() const noexcept override {
+#if defined(CLOCK_MONOTONIC_COARSE)
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &time);
+    return TimePoint{std::chrono::duration_cast<TimePoint::duration>(std::chrono::seconds(time.tv_sec) +
+                                                                     std::chrono::nanoseconds(time.tv_nsec))};
+#else
+    return std::chrono::steady_clock::now();
+#endif
+  }
+  [[nodiscard]] bool isRealTime() const noexcept override {
+    return true;
+  }
+
+  /**
+   * @brief step of the time, zero if the system has no coarse clock
+   */
+  [[nodiscard]] static std::chrono::nanoseconds resolution() noexcept;
+};
+
+/**
+ * @brief Time of steady_clock extrapolated from the CPU time stamp counter.
+ *
+ * A read is one rdtsc and a multiplication. The counter rate is calibrated against steady_clock by
+ * create(), and at least every kReanchorPeriod the first read after it samples steady_clock again:
+ * the time restarts from there and the rate is measured over the whole run, so the extrapolation
+ * never drifts more than a few microseconds from steady_clock. A re-anchor never restarts the time
+ * below the latest one the previous origin could have returned, so now() is monotonic across all
+ * threads without any shared write on a read. now() may be called from any thread.
+ */
+class TscClock : public IClock {
+ public:
+  /// Duration of the calibration by create()
+  static constexpr std::chrono::milliseconds kDefaultCalibration{10};
+  /// Longest extrapolation before steady_clock is sampled again
+  static constexpr std::chrono::seconds kReanchorPeriod{1};
+
+  /**
+   * @brief calibrates the counter, blocks for the calibration
+   * @return nullptr if the CPU has no counter with a constant rate
+   */
+  [[nodiscard]] static std::shared_ptr<TscClock> create(std::chrono::nanoseconds calibration = kDefaultCalibration);
+
+  [[nodiscard]] TimePoint now() const noexcept override {
+    for (;;) {
+      const auto sequence = m_Sequence.load(std::memory_order_acquire);
+      const auto originTicks = m_OriginTicks.load(std::memory_order_relaxed);
+      const auto originTime = m_OriginTime.load(std::memory_order_relaxed);
+      const auto scale = m_Scale.load(std::memory_order_relaxed);
+      // read within the sequence, so the counter of a read on an old origin precedes the new origin
+      const auto ticks = readTicks();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ((sequence & 1U) != 0 || m_Sequence.load(std::memory_order_relaxed) != sequence) {
+        // a re-anchor is running
+        continue;
+      }
+      // signed, the counters of two cores may differ by a few ticks
+      const auto elapsed = static_cast<std::int64_t>(ticks - originTicks);
+      if (elapsed > m_ReanchorTicks) {
+        reanchor(sequence);
+        continue;
+      }
+      // elapsed times scale stays below 2^63 for up to two seconds
+      const auto nanos = (elapsed * static_cast<std::int64_t>(scale)) >> kScaleShift;
+      return TimePoint{std::chrono::duration_cast<TimePoint::duration>(std::chrono::nanoseconds(originTime + nanos))};
+    }
+  }
+  [[nodiscard]] bool isRealTime() const noexcept override {
+    return true;
+  }
+
+  /**
+   * @brief calibrated counter ticks per second
+   */
+  [[nodiscard]] double getFrequency() const noexcept {
+    return static_cast<double>(std::uint64_t{1} << kScaleShift) * 1e9 /
+           static_cast<double>(m_Scale.load(std::memory_order_relaxed));
+  }
+
+  /// A simultaneous reading of the counter and steady_clock
+  struct Sample {
+    std::uint64_t ticks;  ///< Counter
+    std::int64_t time;    ///< Nanoseconds since the epoch of steady_clock
+  };
+
+  /**
+   * @param first - reading the rate is measured from
+   * @param origin - later reading, the origin of the extrapolation
+   */
+  TscClock(Sample first, Sample origin);
+
+ private:
+  /// Fraction bits of the fixed point nanoseconds per tick
+  static constexpr unsigned kScaleShift{32};
+
+  static std::uint64_t readTicks() noexcept {
+#if defined(TEV_HAS_TSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+  }
+  static Sample sample() noexcept;
+  void reanchor(std::uint64_t sequence) const noexcept;
+  void setOrigin(Sample origin, std::int64_t time) const noexcept;
+
+  Sample m_First;                                    ///< Reading the rate is measured from
+  std::int64_t m_ReanchorTicks;                      ///< Ticks of kReanchorPeriod
+  mutable std::atomic<std::uint64_t> m_Sequence{0};  ///< Odd while a re-anchor writes the origin
+  mutable std::atomic<std::uint64_t> m_OriginTicks;  ///< Counter at the origin
+  mutable std::atomic<std::int64_t> m_OriginTime;    ///< steady_clock nanoseconds at the origin
+  mutable std::atomic<std::uint64_t> m_Scale;        ///< Nanoseconds per tick, kScaleShift fraction bits
+};
+
+/**
+ * @brief Virtual time which only moves when it is advanced.
+ *
+ * A scheduler on a manual clock is driven by processEvents(): advancing the clock by the returned
+ * wait jumps straight to the next deadline, so hours of schedule replay in the time the callbacks
+ * take, and every run yields the same deadlines. now() and advance() may be called from any thread.
+ */
+class ManualClock : public IClock {
+ public:
+  /// Start of the virtual time, a fixed point so that runs are repeatable
+  static constexpr TimePoint kDefaultStart{std::chrono::hours(24)};
+
+  explicit ManualClock(TimePoint start = kDefaultStart) : m_Now(start.time_since_epoch().count()) {}
+
+  [[nodiscard]] TimePoint now() const noexcept override {
+    return TimePoint{TimePoint::duration{m_Now.load(std::memory_order_acquire)}};
+  }
+  [[nodiscard]] bool isRealTime() const noexcept override {
+    return false;
+  }
+
+  /**
+   * @brief moves the time forward, negative steps are ignored
+   */
+  void advance(TimePoint::duration step) noexcept {
+    if (step > TimePoint::duration{0}) {
+      m_Now.fetch_add(step.count(), std::memory_order_acq_rel);
+    }
+  }
+
+  /**
+   * @brief moves the time forward to a time point, earlier time points are ignored
+   */
+  void advanceTo(TimePoint time) noexcept {
+    auto current = m_Now.load(std::memory_order_relaxed);
+    while (time.time_since_epoch().count() > current &&
+           !m_Now.compare_exchange_weak(current, time.time_since_epoch().count(), std::memory_order_acq_rel)) {
+    }
+  }
+
+ private:
+  std::atomic<TimePoint::rep> m_Now;  ///< Current time since the epoch of steady_clock
+};
+
+}  // end of namespace tev
@@ -13,11 +13,17 @@
 //-----------------------------------------------------------------------------
 // includes "..."
 //-----------------------------------------------------------------------------
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <stopTimer.hpp>
 
 #include "iController.hpp"
+#include "inplaceFunction.hpp"
 #include "iUserData.hpp"
+#include "latencyHistogram.hpp"
 
 namespace tev {
 
@@ -26,15 +32,44 @@ namespace tev {
  */
 class Event;
 using EventPtr = std::shared_ptr<Event>;
-using DurationUnit = std::chrono::milliseconds;
+/// Unit of all event durations, fine enough for sub-millisecond periods
+using DurationUnit = std::chrono::nanoseconds;
 using namespace std::chrono_literals;
 
 /// Callback function signature for timed events related to controllers.
 /// Parameters:
 /// - controller: a shared pointer to the controller object.
-/// - event: a shared pointer to the timed event object.
-/// Returns the duration of the next timed action.
-using ControllerEventCallback = std::function<void(EventPtr event)>;
+/// - event: a shared pointer to the timed event object, passed without touching its reference count.
+/// Captures are stored inline and limited to TEV_CALLBACK_BUFFER_SIZE bytes, so creating an event never allocates.
+using ControllerEventCallback = InplaceFunction<void(const EventPtr& event)>;
+
+/**
+ * @brief Handling of periods which elapsed entirely while a periodic event waited for service.
+ *
+ * Periods are counted from the start deadline, so a late callback does not shift the following
+ * deadlines. A period is missed when the next deadline already passed as well, e.g. after a slow
+ * callback or while the scheduler thread was descheduled.
+ */
+enum class CatchUpPolicy {
+  Skip,                ///< fire once, drop the missed periods and stay on the original phase
+  FireOnceAndRealign,  ///< fire once, drop the missed periods and count the next period from now
+  Burst                ///< fire once per missed period back to back until the schedule is caught up
+};
+
+/**
+ * @brief Priority class of an event.
+ *
+ * Events due in the same processing pass are served by priority first and by earliest deadline
+ * within a priority, so an overloaded scheduler meets the deadlines of the important events first.
+ */
+enum class Priority : std::uint8_t {
+  Critical,  ///< served before all other events of a pass
+  High,      ///< served before normal and low events
+  Normal,    ///< default
+  Low        ///< served after all other events of a pass, e.g. housekeeping
+};
+/// Number of priority classes
+inline constexpr std::size_t kPriorityLevels{4};
 
 /**
  * @brief Configuration structure for defining parameters of a timed event.
@@ -51,11 +86,18 @@ struct EventConfig {
   ControllerEventCallback abortCallback;
   ControllerEventCallback completeCallback;
   ControllerEventCallback timeoutCallback;
+  CatchUpPolicy catchUpPolicy;
+  /// Tolerated lateness, the event may fire anywhere in [deadline, deadline + slack] to share a wake-up
+  DurationUnit slack{0};
+  /// Order among the events due in the same pass
+  Priority priority{Priority::Normal};
+  /// Record lateness and runtime of the callbacks of this event, sizeof(LatencyHistograms) bytes per event
+  bool latencyHistograms{false};
 
   EventConfig(DurationUnit delayMs, DurationUnit serveMs, DurationUnit lifeMs,
               const ControllerEventCallback& startCallback, const ControllerEventCallback& eventCallback,
               const ControllerEventCallback& abortCallback, const ControllerEventCallback& completeCallback,
-              const ControllerEventCallback& timeoutCallback)
+              const ControllerEventCallback& timeoutCallback, CatchUpPolicy catchUpPolicy = CatchUpPolicy::Skip)
       : delayMs(delayMs),
         serveMs(serveMs),
         lifeMs(lifeMs),
@@ -63,7 +105,27 @@ struct EventConfig {
         eventCallback(eventCallback),
         abortCallback(abortCallback),
         completeCallback(completeCallback),
-        timeoutCallback(timeoutCallback) {}
+        timeoutCallback(timeoutCallback),
+        catchUpPolicy(catchUpPolicy) {}
+};
+
+/**
+ * @brief Lightweight reference to a scheduled event.
+ *
+ * Refers to a slot of the scheduler handle table and the generation the slot had when the
+ * event was pushed. The slot generation advances when the event leaves the scheduler, so a
+ * handle outliving its event is detected as stale instead of reaching a recycled slot.
+ */
+struct EventHandle {
+  static constexpr std::uint32_t kInvalidSlot{std::numeric_limits<std::uint32_t>::max()};
+
+  std::uint32_t slot{kInvalidSlot};  ///< Index in the handle table
+  std::uint32_t generation{0};       ///< Slot generation at push time
+
+  [[nodiscard]] bool valid() const noexcept {
+    return slot != kInvalidSlot;
+  }
+  friend bool operator==(const EventHandle&, const EventHandle&) = default;
 };
 
 /**
@@ -72,14 +134,19 @@ struct EventConfig {
  * The Event class provides functionality to manage timed events, including their start delay,
  * execution interval, maximum lifespan, and associated callbacks for different stages of
  * event execution. It supports user-defined data and integrates with a controlling entity.
+ *
+ * The scheduler starts the event and life clocks at time points of its own clock, so the deadlines
+ * of an event follow a virtual clock injected into the scheduler as well.
  */
 class Event : public std::enable_shared_from_this<Event> {
  public:
-  using EventClock = tkcppsl::time::StopTimer<>;
+  using EventClock = tkcppsl::time::StopTimer<DurationUnit>;
   static constexpr DurationUnit kDefaultIntervalMs{1000ms};
   static constexpr DurationUnit kDefaultLifeMs{60000ms};
-  static constexpr DurationUnit kDefaultDelayDuration{std::chrono::milliseconds::min()};
-  static constexpr DurationUnit kDefaultEndlessLifeMs{std::chrono::milliseconds::max()};
+  static constexpr DurationUnit kNoDuration{DurationUnit::min()};
+  static constexpr DurationUnit kDefaultDelayDuration{kNoDuration};
+  static constexpr DurationUnit kDefaultEndlessLifeMs{DurationUnit::max()};
+  static constexpr std::size_t kNotQueued{std::numeric_limits<std::size_t>::max()};
 
   // Status Enum
   enum class Status { Pending, Running, Completed, Aborted, Timeouted };
@@ -94,7 +161,11 @@ class Event : public std::enable_shared_from_this<Event> {
         m_UserData(userData),
         m_StartDelay(config.delayMs),
         m_ServeInterval(config.serveMs),
-        m_MaxLifeDuration(config.lifeMs) {
+        m_MaxLifeDuration(config.lifeMs),
+        m_CatchUpPolicy(config.catchUpPolicy),
+        m_Slack(config.slack),
+        m_Priority(config.priority),
+        m_Latency(config.latencyHistograms ? std::make_unique<LatencyHistograms>() : nullptr) {
     // set func
     m_StartFunc = config.startCallback;
     m_EventFunc = config.eventCallback;
@@ -110,12 +181,18 @@ class Event : public std::enable_shared_from_this<Event> {
 
   virtual ~Event() = default;
 
-  [[nodiscard]] std::shared_ptr<IController> getController() {
+  [[nodiscard]] const std::shared_ptr<IController>& getController() const {
     return m_Controller;
   }
   [[nodiscard]] Status getStatus() {
     return m_Status;
   }
+  /**
+   * @brief whether the event waits for the start callback, false for kDefaultDelayDuration
+   */
+  [[nodiscard]] bool hasStartDelay() const {
+    return m_StartDelay != kDefaultDelayDuration;
+  }
   [[nodiscard]] DurationUnit& getStartDelay() {
     return m_StartDelay;
   }
@@ -128,6 +205,42 @@ class Event : public std::enable_shared_from_this<Event> {
   void setServeInterval(const DurationUnit& serveInterval) {
     m_ServeInterval = serveInterval;
   }
+  [[nodiscard]] CatchUpPolicy getCatchUpPolicy() const {
+    return m_CatchUpPolicy;
+  }
+  void setCatchUpPolicy(CatchUpPolicy catchUpPolicy) {
+    m_CatchUpPolicy = catchUpPolicy;
+  }
+  [[nodiscard]] DurationUnit getSlack() const {
+    return m_Slack;
+  }
+  void setSlack(const DurationUnit& slack) {
+    m_Slack = slack;
+  }
+  [[nodiscard]] Priority getPriority() const {
+    return m_Priority;
+  }
+  void setPriority(Priority priority) {
+    m_Priority = priority;
+  }
+  /**
+   * @brief timing histograms of the callbacks, nullptr unless EventConfig::latencyHistograms is set
+   */
+  [[nodiscard]] const LatencyHistograms* getLatencyHistograms() const {
+    return m_Latency.get();
+  }
+  [[nodiscard]] LatencyHistograms* getLatencyHistograms() {
+    return m_Latency.get();
+  }
+  /**
+   * @brief number of periods dropped by the catch-up policy since the event was created
+   */
+  [[nodiscard]] std::uint64_t getMissedPeriods() const {
+    return m_MissedPeriods;
+  }
+  void addMissedPeriods(std::uint64_t missedPeriods) {
+    m_MissedPeriods += missedPeriods;
+  }
   [[nodiscard]] DurationUnit& getLifeDuration() {
     return m_MaxLifeDuration;
   }
@@ -188,14 +301,54 @@ class Event : public std::enable_shared_from_this<Event> {
   void setLastProcTimePoint(const std::chrono::steady_clock::time_point& lastTp) {
     m_LastProcTimePoint = lastTp;
   }
+  [[nodiscard]] std::size_t getQueueIndex() const {
+    return m_QueueIndex;
+  }
+  void setQueueIndex(std::size_t queueIndex) {
+    m_QueueIndex = queueIndex;
+  }
+  [[nodiscard]] std::size_t getQueueSlot() const {
+    return m_QueueSlot;
+  }
+  void setQueueSlot(std::size_t queueSlot) {
+    m_QueueSlot = queueSlot;
+  }
+  /**
+   * @brief handle of the last push, readable and written from any thread
+   */
+  [[nodiscard]] EventHandle getHandle() const {
+    const auto packed = m_Handle.load(std::memory_order_acquire);
+    return EventHandle{static_cast<std::uint32_t>(packed >> 32U), static_cast<std::uint32_t>(packed)};
+  }
+  void setHandle(const EventHandle& handle) {
+    m_Handle.store(pack(handle), std::memory_order_release);
+  }
+  /**
+   * @brief handle of the push the scheduler applied last, only used by the thread owning the events
+   */
+  [[nodiscard]] const EventHandle& getArmedHandle() const {
+    return m_ArmedHandle;
+  }
+  void setArmedHandle(const EventHandle& handle) {
+    m_ArmedHandle = handle;
+  }
 
  private:
+  static constexpr std::uint64_t pack(const EventHandle& handle) {
+    return (std::uint64_t{handle.slot} << 32U) | handle.generation;
+  }
+
   std::shared_ptr<IController> m_Controller;                  ///< Associated controller
   std::shared_ptr<IUserData> m_UserData;                      ///< Encapsulated user-defined event data
   Status m_Status{Status::Pending};                           ///< Status of the event
   DurationUnit m_StartDelay{kDefaultDelayDuration};           ///< Optional delay before the event starts
   DurationUnit m_ServeInterval{kDefaultIntervalMs};           ///< Interval for serving this event
   DurationUnit m_MaxLifeDuration{kDefaultEndlessLifeMs};      ///< Maximum lifespan of the event
+  CatchUpPolicy m_CatchUpPolicy{CatchUpPolicy::Skip};         ///< Handling of missed periods
+  DurationUnit m_Slack{0};                                    ///< Tolerated lateness for coalesced wake-ups
+  Priority m_Priority{Priority::Normal};                      ///< Order among the events due in the same pass
+  std::unique_ptr<LatencyHistograms> m_Latency;               ///< Callback timing of this event, optional
+  std::uint64_t m_MissedPeriods{0};                           ///< Periods dropped by the catch-up policy
   EventClock m_EventClock;                                    ///< Clock object for timing the event
   EventClock m_LifeClock;                                     ///< Clock object for lifetime tracking
   ControllerEventCallback m_StartFunc{nullptr};               ///< Function pointer for handling start event execution
@@ -204,6 +357,10 @@ class Event : public std::enable_shared_from_this<Event> {
   ControllerEventCallback m_CompleteFunc{nullptr};            ///< Callback function executed on event completion
   ControllerEventCallback m_TimeoutFunc{nullptr};             ///< Callback executed on timeout
   std::chrono::steady_clock::time_point m_LastProcTimePoint;  ///< Last process point in time
+  std::size_t m_QueueIndex{kNotQueued};                       ///< Position in the scheduler queue
+  std::size_t m_QueueSlot{kNotQueued};                        ///< Bucket in the scheduler queue, if it has buckets
+  std::atomic<std::uint64_t> m_Handle{pack(EventHandle{})};   ///< Slot and generation of the last push
+  EventHandle m_ArmedHandle;                                  ///< Handle of the last applied push
 };
 
 }  // end of namespace tev
@@ -0,0 +1,135 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the table behind event handles.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "event.hpp"
+
+namespace tev {
+
+/**
+ * @brief Slot table resolving event handles in O(1).
+ *
+ * Slots live in chunks which are allocated on demand and never freed or moved, so a slot can be
+ * read from any thread without a lock. Released slots are recycled through a lock-free free list,
+ * whose head carries a tag against ABA. Every release advances the slot generation, which turns all
+ * handles of the previous occupant stale.
+ *
+ * A handle slot carries the index in its lower kIndexBits and the tag of the table in its upper
+ * bits, so the table a handle came from is known without asking the tables, and a table rejects
+ * the handles of others.
+ *
+ * acquire(), isLive() and getStatus() may be called from any thread. release(), setStatus() and
+ * get() belong to the thread owning the scheduled events, which is the only one releasing slots.
+ */
+class EventHandleTable {
+ public:
+  static constexpr std::uint32_t kChunkBits{12};
+  static constexpr std::uint32_t kChunkSize{1U << kChunkBits};
+  static constexpr std::uint32_t kMaxChunkBits{12};
+  static constexpr std::uint32_t kMaxChunks{1U << kMaxChunkBits};
+  static constexpr std::uint32_t kIndexBits{kChunkBits + kMaxChunkBits};
+  /// Largest tag, the all-ones tag would turn the last index into EventHandle::kInvalidSlot
+  static constexpr std::uint32_t kMaxTag{(1U << (32 - kIndexBits)) - 2};
+
+  /**
+   * @param tag - upper bits of the handle slots, up to kMaxTag
+   * @throws std::invalid_argument if the tag is larger than kMaxTag
+   */
+  explicit EventHandleTable(std::uint32_t tag = 0);
+  virtual ~EventHandleTable();
+  EventHandleTable(const EventHandleTable&) = delete;
+  EventHandleTable& operator=(const EventHandleTable&) = delete;
+
+  /**
+   * @brief takes a free slot for an event
+   * @param event - event referred to by the slot
+   * @return handle of the slot, status Pending
+   * @throws std::length_error if all kMaxChunks * kChunkSize slots are in use
+   */
+  [[nodiscard]] EventHandle acquire(Event* event);
+
+  /**
+   * @brief returns the slot of a handle to the free list
+   * @return false if the handle was already stale
+   */
+  bool release(const EventHandle& handle);
+
+  /**
+   * @brief checks whether the handle refers to its event still
+   */
+  [[nodiscard]] bool isLive(const EventHandle& handle) const;
+
+  /**
+   * @brief status of the event as recorded by the owning thread, nothing for stale handles
+   */
+  [[nodiscard]] std::optional<Event::Status> getStatus(const EventHandle& handle) const;
+  void setStatus(const EventHandle& handle, Event::Status status);
+
+  /**
+   * @brief event of a live handle, nullptr for stale handles
+   */
+  [[nodiscard]] Event* get(const EventHandle& handle) const;
+
+  /**
+   * @brief number of slots ever taken from the chunks, live or free
+   */
+  [[nodiscard]] std::uint32_t getCapacity() const {
+    return m_Next.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] std::uint32_t getTag() const {
+    return m_Tag;
+  }
+  /**
+   * @brief tag of the table a valid handle was acquired from
+   */
+  [[nodiscard]] static constexpr std::uint32_t tagOfHandle(const EventHandle& handle) {
+    return handle.slot >> kIndexBits;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<std::uint32_t> generation{0};                        ///< Advanced on every release
+    std::atomic<Event::Status> status{Event::Status::Pending};       ///< Status of the last pass
+    std::atomic<Event*> event{nullptr};                              ///< Event of the current generation
+    std::atomic<std::uint32_t> nextFree{EventHandle::kInvalidSlot};  ///< Next slot on the free list
+  };
+
+  static constexpr std::uint32_t kIndexMask{(1U << kIndexBits) - 1};
+
+  static constexpr std::uint64_t pack(std::uint32_t slot, std::uint32_t tag) {
+    return (static_cast<std::uint64_t>(tag) << 32) | slot;
+  }
+  static constexpr std::uint32_t slotOf(std::uint64_t head) {
+    return static_cast<std::uint32_t>(head);
+  }
+  static constexpr std::uint32_t tagOf(std::uint64_t head) {
+    return static_cast<std::uint32_t>(head >> 32);
+  }
+
+  [[nodiscard]] Slot* find(std::uint32_t index) const;
+  [[nodiscard]] Slot* find(const EventHandle& handle) const;
+  Slot& ensure(std::uint32_t index);
+  EventHandle bind(std::uint32_t index, Slot& slot, Event* event);
+
+  std::uint32_t m_Tag;                                                        ///< Upper bits of the handle slots
+  std::array<std::atomic<Slot*>, kMaxChunks> m_Chunks{};                      ///< Slot chunks, allocated on demand
+  std::atomic<std::uint32_t> m_Next{0};                                       ///< First slot never handed out
+  std::atomic<std::uint64_t> m_FreeHead{pack(EventHandle::kInvalidSlot, 0)};  ///< Free list head and ABA tag
+};
+
+}  // end of namespace tev
@@ -0,0 +1,249 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains deadline-ordered heap of scheduled events.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "event.hpp"
+#include "iEventQueue.hpp"
+
+namespace tev {
+
+/**
+ * @brief 4-ary min-heap of scheduled events keyed on their next deadline.
+ *
+ * The event with the earliest deadline is always on top, so the scheduler reads the next wake-up time
+ * in O(1) and only touches events which are due. Every event stores its position in the heap, which
+ * allows erase and re-keying in O(log n) without searching the queue.
+ */
+class EventHeap : public IEventQueue {
+ public:
+  static constexpr std::size_t kArity{4};
+
+  /// Heap entry: the deadline is kept next to the event to keep comparisons in cache.
+  struct Entry {
+    TimePoint deadline;  ///< Next deadline of the event
+    EventPtr event;      ///< Scheduled event
+  };
+
+  [[nodiscard]] std::size_t size() const noexcept override {
+    return m_Entries.size();
+  }
+  [[nodiscard]] const Entry& top() const {
+    return m_Entries.front();
+  }
+  [[nodiscard]] auto begin() const {
+    return m_Entries.cbegin();
+  }
+  [[nodiscard]] auto end() const {
+    return m_Entries.cend();
+  }
+  void reserve(std::size_t count) override {
+    m_Entries.reserve(count);
+  }
+
+  /**
+   * @brief checks whether the event is stored in this heap
+   * @param event - event to look for
+   * @return true if the event is queued here
+   */
+  [[nodiscard]] bool contains(const Event& event) const noexcept override {
+    const auto index = event.getQueueIndex();
+    return index < m_Entries.size() && m_Entries[index].event.get() == &event;
+  }
+
+  /**
+   * @brief insert an event with its deadline
+   * @param event - event to insert
+   * @param deadline - next deadline of the event
+   */
+  void push(EventPtr event, TimePoint deadline) override {
+    m_Entries.push_back(Entry{deadline, std::move(event)});
+    siftUp(m_Entries.size() - 1);
+  }
+
+  /**
+   * @brief remove the event with the earliest deadline
+   * @return removed event
+   */
+  EventPtr pop() {
+    return removeAt(0);
+  }
+
+  /**
+   * @brief change the deadline of a queued event
+   * @param event - queued event
+   * @param deadline - new deadline
+   * @return false if the event is not queued in this heap
+   */
+  bool update(const Event& event, TimePoint deadline) override {
+    if (!contains(event)) {
+      return false;
+    }
+    const auto index = event.getQueueIndex();
+    const bool earlier = deadline < m_Entries[index].deadline;
+    m_Entries[index].deadline = deadline;
+    if (earlier) {
+      siftUp(index);
+    } else {
+      siftDown(index);
+    }
+    return true;
+  }
+
+  /**
+   * @brief remove a queued event
+   * @param event - event to remove
+   * @return removed event or nullptr if the event is not queued in this heap
+   */
+  EventPtr erase(const Event& event) override {
+    if (!contains(event)) {
+      return nullptr;
+    }
+    return removeAt(event.getQueueIndex());
+  }
+
+  /**
+   * @brief remove all events matching a predicate
+   * @details linear pass followed by a bottom-up rebuild of the heap
+   * @param pred - predicate called with the event pointer
+   * @return number of removed events
+   */
+  std::size_t eraseIf(const EventPredicate& pred) override {
+    std::size_t kept = 0;
+    for (auto& entry : m_Entries) {
+      if (pred(entry.event)) {
+        entry.event->setQueueIndex(Event::kNotQueued);
+      } else {
+        m_Entries[kept++] = std::move(entry);
+      }
+    }
+    const auto removed = m_Entries.size() - kept;
+    m_Entries.resize(kept);
+    if (removed != 0) {
+      rebuild();
+    }
+    return removed;
+  }
+
+  /**
+   * @brief earliest deadline
+   * @return deadline of the top event, std::nullopt if empty
+   */
+  [[nodiscard]] std::optional<TimePoint> earliestDeadline() const override {
+    if (m_Entries.empty()) {
+      return std::nullopt;
+    }
+    return m_Entries.front().deadline;
+  }
+
+  /**
+   * @brief move all due events into a vector
+   * @details pops from the top until the first event which is not due, in deadline order
+   * @param now - current time
+   * @param due - receives the due events
+   */
+  void popDue(TimePoint now, std::vector<EventPtr>& due) override {
+    while (!m_Entries.empty() && m_Entries.front().deadline <= now) {
+      due.push_back(pop());
+    }
+  }
+
+  /**
+   * @brief remove all events
+   */
+  void clear() override {
+    for (auto& entry : m_Entries) {
+      entry.event->setQueueIndex(Event::kNotQueued);
+    }
+    m_Entries.clear();
+  }
+
+ private:
+  EventPtr removeAt(std::size_t index) {
+    auto removed = std::move(m_Entries[index].event);
+    removed->setQueueIndex(Event::kNotQueued);
+    auto last = std::move(m_Entries.back());
+    m_Entries.pop_back();
+    if (index < m_Entries.size()) {
+      const bool earlier = last.deadline < m_Entries[index].deadline;
+      place(index, std::move(last));
+      if (earlier) {
+        siftUp(index);
+      } else {
+        siftDown(index);
+      }
+    }
+    return removed;
+  }
+
+  void place(std::size_t index, Entry&& entry) {
+    m_Entries[index] = std::move(entry);
+    m_Entries[index].event->setQueueIndex(index);
+  }
+
+  void siftUp(std::size_t index) {
+    auto entry = std::move(m_Entries[index]);
+    while (index > 0) {
+      const auto parent = (index - 1) / kArity;
+      if (!(entry.deadline < m_Entries[parent].deadline)) {
+        break;
+      }
+      place(index, std::move(m_Entries[parent]));
+      index = parent;
+    }
+    place(index, std::move(entry));
+  }
+
+  void siftDown(std::size_t index) {
+    const auto count = m_Entries.size();
+    auto entry = std::move(m_Entries[index]);
+    while (true) {
+      const auto first = index * kArity + 1;
+      if (first >= count) {
+        break;
+      }
+      const auto last = first + kArity < count ? first + kArity : count;
+      auto best = first;
+      for (auto child = first + 1; child < last; ++child) {
+        if (m_Entries[child].deadline < m_Entries[best].deadline) {
+          best = child;
+        }
+      }
+      if (!(m_Entries[best].deadline < entry.deadline)) {
+        break;
+      }
+      place(index, std::move(m_Entries[best]));
+      index = best;
+    }
+    place(index, std::move(entry));
+  }
+
+  void rebuild() {
+    for (std::size_t index = 0; index < m_Entries.size(); ++index) {
+      m_Entries[index].event->setQueueIndex(index);
+    }
+    if (m_Entries.size() > 1) {
+      for (auto index = (m_Entries.size() - 2) / kArity + 1; index-- > 0;) {
+        siftDown(index);
+      }
+    }
+  }
+
+  std::vector<Entry> m_Entries;  ///< Heap storage, the earliest deadline at index 0
+};
+
+}  // end of namespace tev
@@ -0,0 +1,199 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for tracing event lifecycles into per-thread ring buffers.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "clock.hpp"
+#include "event.hpp"
+
+namespace tev {
+
+/**
+ * @brief Records lifecycle transitions, callbacks and scheduler waits for a Chrome trace.
+ *
+ * Every thread recording into the tracer gets a ring buffer of its own on its first record, so
+ * recording takes no lock and never contends with other threads: a few relaxed stores and a clock
+ * read. A full ring overwrites its oldest records, the tracer keeps the latest history of every
+ * thread in fixed memory. Records are stamped with the clock of the scheduler, so a trace of a
+ * scheduler on a manual clock shows its virtual time.
+ *
+ * snapshot() and writeChromeTrace() may be called while threads record. Records overwritten during
+ * the copy are left out, so a dump never contains torn records. The Chrome trace JSON opens in
+ * Perfetto or chrome://tracing with one track per thread: callbacks and waits are slices, lifecycle
+ * transitions are instants, all tagged with the slot and generation of the event handle.
+ */
+class EventTracer {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  /// Kind of a record
+  enum class Kind : std::uint8_t {
+    Status,         ///< lifecycle transition of an event
+    CallbackBegin,  ///< an event callback starts
+    CallbackEnd,    ///< an event callback returned
+    Sleep,          ///< the scheduler thread starts to wait
+    Wake            ///< the scheduler thread woke up
+  };
+
+  /// Callback of an event
+  enum class Callback : std::uint8_t { Start, Serve, Complete, Abort, Timeout };
+
+  /// One record as copied by snapshot()
+  struct Record {
+    TimePoint time;                              ///< Time of the record
+    Kind kind{Kind::Status};                     ///< What happened
+    EventHandle event;                           ///< Event of Status and Callback records
+    Event::Status from{Event::Status::Pending};  ///< Status before the transition
+    Event::Status to{Event::Status::Pending};    ///< Status after the transition
+    Callback callback{Callback::Start};          ///< Callback of CallbackBegin and CallbackEnd
+    bool notified{false};                        ///< Wake by a notification instead of the deadline
+  };
+
+  /// Records of one thread, oldest first
+  struct ThreadTrace {
+    std::string name;             ///< Name given by nameThread(), "thread <n>" otherwise
+    std::vector<Record> records;  ///< Records still in the ring
+    std::uint64_t dropped{0};     ///< Records overwritten before the snapshot
+  };
+
+  /**
+   * @param capacity - records kept per thread, rounded up to a power of two
+   * @param clock - time of the records, nullptr for steady_clock
+   */
+  explicit EventTracer(std::size_t capacity, std::shared_ptr<IClock> clock = nullptr);
+  virtual ~EventTracer() = default;
+  EventTracer(const EventTracer&) = delete;
+  EventTracer& operator=(const EventTracer&) = delete;
+
+  void status(const EventHandle& event, Event::Status from, Event::Status to) {
+    status(event, from, to, m_Clock->now());
+  }
+  void status(const EventHandle& event, Event::Status from, Event::Status to, TimePoint time) {
+    const auto transition = (static_cast<unsigned>(from) << 4U) | static_cast<unsigned>(to);
+    record(Kind::Status, event, static_cast<std::uint8_t>(transition), time);
+  }
+  void callbackBegin(const EventHandle& event, Callback callback) {
+    record(Kind::CallbackBegin, event, static_cast<std::uint8_t>(callback));
+  }
+  void callbackEnd(const EventHandle& event, Callback callback) {
+    record(Kind::CallbackEnd, event, static_cast<std::uint8_t>(callback));
+  }
+  /**
+   * @brief records the end of a callback at a time the caller has read from the clock already
+   */
+  void callbackEnd(const EventHandle& event, Callback callback, TimePoint time) {
+    record(Kind::CallbackEnd, event, static_cast<std::uint8_t>(callback), time);
+  }
+  void sleep() {
+    record(Kind::Sleep, EventHandle{}, 0);
+  }
+  void wake(bool notified) {
+    record(Kind::Wake, EventHandle{}, notified ? 1 : 0);
+  }
+
+  /**
+   * @brief names the track of the calling thread in the trace
+   */
+  void nameThread(std::string name);
+
+  /**
+   * @brief copies the records of all threads without stopping them
+   */
+  [[nodiscard]] std::vector<ThreadTrace> snapshot() const;
+
+  /**
+   * @brief writes the records in the Chrome trace event format
+   * @details Times are microseconds since the oldest record. A callback or wait whose begin was
+   * overwritten is left out, one still running at the snapshot is open until the end of the trace.
+   */
+  void writeChromeTrace(std::ostream& out) const;
+
+  /**
+   * @brief writes the Chrome trace to a file
+   * @return false if the file could not be written
+   */
+  bool writeFile(const std::string& path) const;
+
+  [[nodiscard]] std::size_t getCapacity() const {
+    return m_Mask + 1;
+  }
+
+ private:
+  /// One record in a ring, atomic words so that a concurrent snapshot is no data race
+  struct Slot {
+    std::atomic<std::int64_t> time{0};    ///< Clock ticks since the epoch of the tracer clock
+    std::atomic<std::uint64_t> event{0};  ///< Slot and generation of the event handle
+    std::atomic<std::uint16_t> meta{0};   ///< Kind and detail
+  };
+
+  /// Records of one thread, written only by this thread
+  struct Ring {
+    explicit Ring(std::size_t capacity) : slots(std::make_unique<Slot[]>(capacity)) {}
+
+    std::unique_ptr<Slot[]> slots;            ///< Ring storage
+    std::atomic<std::uint64_t> claimed{0};    ///< Records started, a slot is overwritten from here on
+    std::atomic<std::uint64_t> committed{0};  ///< Records complete
+    std::thread::id thread;                   ///< Recording thread
+    std::string name;                         ///< Track name, guarded by m_Mutex
+  };
+
+  void record(Kind kind, const EventHandle& event, std::uint8_t detail) {
+    record(kind, event, detail, m_Clock->now());
+  }
+  void record(Kind kind, const EventHandle& event, std::uint8_t detail, TimePoint time) {
+    auto& ring = ringOfThread();
+    const auto index = ring.committed.load(std::memory_order_relaxed);
+    // announce the overwrite before the slot changes, see snapshot()
+    ring.claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    auto& slot = ring.slots[index & m_Mask];
+    slot.time.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+    slot.event.store((std::uint64_t{event.slot} << 32U) | event.generation, std::memory_order_relaxed);
+    slot.meta.store(static_cast<std::uint16_t>((static_cast<unsigned>(kind) << 8U) | detail),
+                    std::memory_order_relaxed);
+    ring.committed.store(index + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief ring of the calling thread, registered on its first record
+   */
+  Ring& ringOfThread() {
+    // a thread usually records into one tracer, the last one is cached per thread
+    thread_local std::uint64_t cachedTracer{0};
+    thread_local Ring* cachedRing{nullptr};
+    if (cachedTracer != m_Id) {
+      cachedRing = &registerThread();
+      cachedTracer = m_Id;
+    }
+    return *cachedRing;
+  }
+  Ring& registerThread();
+
+  std::size_t m_Mask;                          ///< Capacity of a ring minus one
+  std::shared_ptr<IClock> m_Clock;             ///< Time of the records
+  std::uint64_t m_Id;                          ///< Unique id of the tracer, key of the per-thread cache
+  mutable std::mutex m_Mutex;                  ///< Guards m_Rings
+  std::vector<std::unique_ptr<Ring>> m_Rings;  ///< Rings of all threads which recorded
+};
+
+}  // end of namespace tev
@@ -0,0 +1,60 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains the interface of the deadline-ordered queues of scheduled events.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "event.hpp"
+
+namespace tev {
+
+/// Abstract deadline-ordered queue of scheduled events
+class IEventQueue {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+  using EventPredicate = std::function<bool(const EventPtr&)>;
+
+  virtual ~IEventQueue() = default;
+
+  /// Number of queued events
+  [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+  /// Checks whether the event is stored in this queue
+  [[nodiscard]] virtual bool contains(const Event& event) const noexcept = 0;
+  /// Earliest point in time at which the queue may have due events, std::nullopt if empty
+  [[nodiscard]] virtual std::optional<TimePoint> earliestDeadline() const = 0;
+
+  /// Insert an event with its deadline
+  virtual void push(EventPtr event, TimePoint deadline) = 0;
+  /// Change the deadline of a queued event, false if the event is not queued here
+  virtual bool update(const Event& event, TimePoint deadline) = 0;
+  /// Remove a queued event, nullptr if the event is not queued here
+  virtual EventPtr erase(const Event& event) = 0;
+  /// Remove all events matching a predicate, returns the number of removed events
+  virtual std::size_t eraseIf(const EventPredicate& pred) = 0;
+  /// Move all events with a deadline not later than now into due
+  virtual void popDue(TimePoint now, std::vector<EventPtr>& due) = 0;
+  /// Remove all events
+  virtual void clear() = 0;
+  /// Prepare the storage for count events
+  virtual void reserve(std::size_t count) = 0;
+
+  [[nodiscard]] bool empty() const noexcept {
+    return size() == 0;
+  }
+};
+
+}  // end of namespace tev
@@ -0,0 +1,151 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the allocation-free callable wrapper.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//----------------------------------------------------------------------------
+// Public Defines and Macros
+//----------------------------------------------------------------------------
+/// Inline buffer bytes of an event callback, six pointers by default, callables with larger captures do not compile
+#ifndef TEV_CALLBACK_BUFFER_SIZE
+#define TEV_CALLBACK_BUFFER_SIZE 48
+#endif
+
+namespace tev {
+
+template <class Signature, std::size_t Capacity = TEV_CALLBACK_BUFFER_SIZE>
+class InplaceFunction;
+
+/**
+ * @brief Copyable type-erased callable stored in a fixed inline buffer.
+ *
+ * Replaces std::function where construction must never allocate: the callable lives in a buffer of
+ * Capacity bytes next to a pointer to a static operation table, so the wrapper is Capacity plus one
+ * pointer in size. A callable which does not fit the buffer is rejected at compile time.
+ *
+ * @tparam R - result type
+ * @tparam Args - argument types
+ * @tparam Capacity - buffer size in bytes
+ */
+template <class R, class... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+ public:
+  static constexpr std::size_t kAlignment{alignof(void*)};
+
+  InplaceFunction() noexcept = default;
+  InplaceFunction(std::nullptr_t) noexcept {}  // NOLINT: implicit like std::function
+
+  template <class F, class Callable = std::decay_t<F>,
+            class = std::enable_if_t<!std::is_same_v<Callable, InplaceFunction> &&
+                                     std::is_invocable_r_v<R, Callable&, Args...>>>
+  InplaceFunction(F&& callable) {  // NOLINT: implicit like std::function
+    static_assert(sizeof(Callable) <= Capacity,
+                  "callable exceeds the inline buffer, capture less or raise TEV_CALLBACK_BUFFER_SIZE");
+    static_assert(alignof(Callable) <= kAlignment, "callable is over-aligned for the inline buffer");
+    static_assert(std::is_copy_constructible_v<Callable>, "callable must be copyable");
+    static_assert(std::is_nothrow_move_constructible_v<Callable>, "callable must be nothrow movable");
+    ::new (static_cast<void*>(m_Buffer)) Callable(std::forward<F>(callable));
+    m_Ops = &kOps<Callable>;
+  }
+
+  InplaceFunction(const InplaceFunction& other) : m_Ops(other.m_Ops) {
+    if (m_Ops != nullptr) {
+      m_Ops->copy(m_Buffer, other.m_Buffer);
+    }
+  }
+  InplaceFunction(InplaceFunction&& other) noexcept : m_Ops(other.m_Ops) {
+    if (m_Ops != nullptr) {
+      m_Ops->move(m_Buffer, other.m_Buffer);
+      other.m_Ops = nullptr;
+    }
+  }
+  InplaceFunction& operator=(const InplaceFunction& other) {
+    if (this != &other) {
+      reset();
+      if (other.m_Ops != nullptr) {
+        other.m_Ops->copy(m_Buffer, other.m_Buffer);
+        m_Ops = other.m_Ops;
+      }
+    }
+    return *this;
+  }
+  InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.m_Ops != nullptr) {
+        other.m_Ops->move(m_Buffer, other.m_Buffer);
+        m_Ops = other.m_Ops;
+        other.m_Ops = nullptr;
+      }
+    }
+    return *this;
+  }
+  InplaceFunction& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  // not virtual, the wrapper is a value type of exactly Capacity plus one pointer
+  ~InplaceFunction() {
+    reset();
+  }
+
+  R operator()(Args... args) const {
+    return m_Ops->invoke(m_Buffer, std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const noexcept {
+    return m_Ops != nullptr;
+  }
+  friend bool operator==(const InplaceFunction& function, std::nullptr_t) noexcept {
+    return !function;
+  }
+
+ private:
+  /// Operations of the stored callable type
+  struct Ops {
+    R (*invoke)(void* callable, Args&&... args);
+    void (*copy)(void* target, const void* source);
+    void (*move)(void* target, void* source) noexcept;
+    void (*destroy)(void* callable) noexcept;
+  };
+
+  template <class Callable>
+  static constexpr Ops kOps{
+      [](void* callable, Args&&... args) -> R {
+        return (*static_cast<Callable*>(callable))(std::forward<Args>(args)...);
+      },
+      [](void* target, const void* source) {
+        ::new (target) Callable(*static_cast<const Callable*>(source));
+      },
+      [](void* target, void* source) noexcept {
+        ::new (target) Callable(std::move(*static_cast<Callable*>(source)));
+        static_cast<Callable*>(source)->~Callable();
+      },
+      [](void* callable) noexcept {
+        static_cast<Callable*>(callable)->~Callable();
+      }};
+
+  void reset() noexcept {
+    if (m_Ops != nullptr) {
+      m_Ops->destroy(m_Buffer);
+      m_Ops = nullptr;
+    }
+  }
+
+  alignas(kAlignment) mutable std::byte m_Buffer[Capacity];  ///< Storage of the callable
+  const Ops* m_Ops{nullptr};                                 ///< Operations, nullptr when empty
+};
+
+}  // end of namespace tev
@@ -0,0 +1,70 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the io_uring deadline wait.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace tev {
+
+/**
+ * @brief Waits for an absolute deadline or a wake-up on an io_uring.
+ *
+ * The deadline is an IORING_OP_TIMEOUT with IORING_TIMEOUT_ABS on CLOCK_MONOTONIC, the wake-up an
+ * IORING_OP_POLL_ADD on an eventfd which stays armed between waits. A wait submits the new timeout,
+ * cancels the previous one if still pending and blocks in the same io_uring_enter call, so a fired
+ * timer costs one system call. The ring is driven by raw system calls and needs no liburing.
+ *
+ * The eventfd is used for cross-thread wake-ups instead of IORING_OP_MSG_RING because the waking
+ * threads, any thread pushing an event, do not own a ring.
+ *
+ * waitUntil() belongs to one thread, wake() may be called from any thread.
+ */
+class IoUringWaiter {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  /**
+   * @brief sets up a ring
+   * @return nullptr if the system has no io_uring or does not permit it
+   */
+  [[nodiscard]] static std::unique_ptr<IoUringWaiter> create();
+
+  virtual ~IoUringWaiter();
+  IoUringWaiter(const IoUringWaiter&) = delete;
+  IoUringWaiter& operator=(const IoUringWaiter&) = delete;
+
+  /**
+   * @brief blocks until deadline or a wake-up
+   * @details Returns at once after a request or system call of the ring failed, see getError().
+   * @return true if woken, wake-ups before the call count as well
+   */
+  bool waitUntil(TimePoint deadline);
+
+  /**
+   * @brief errno of the failure which stopped the ring, 0 while it works
+   */
+  [[nodiscard]] int getError() const noexcept;
+
+  /**
+   * @brief ends the current or the next waitUntil()
+   */
+  void wake() noexcept;
+
+ private:
+  IoUringWaiter() = default;
+
+  struct Ring;
+
+  std::unique_ptr<Ring> m_Ring;  ///< Mapped rings and descriptors
+};
+
+}  // end of namespace tev
@@ -0,0 +1,158 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for lock-free latency histograms.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace tev {
+
+/**
+ * @brief Histogram of durations in fixed memory with a bounded relative error, like HdrHistogram.
+ *
+ * The buckets are log-linear: values below 2^kSubBucketBits nanoseconds have a bucket each, every
+ * further power of two is split into 2^(kSubBucketBits - 1) buckets of equal width. A bucket is thus
+ * at most 1/32 of its values wide and quantiles are exact to about 3 %, from nanoseconds up to the
+ * largest tracked value of about 68 s, above which values are counted in the last bucket.
+ *
+ * record() is lock-free, a few relaxed atomic operations without allocation, and may be called from
+ * any number of threads while snapshot() reads the histogram. A snapshot taken during recording may
+ * lag a few values behind, it never blocks the recording threads.
+ */
+class LatencyHistogram {
+ public:
+  using Duration = std::chrono::nanoseconds;
+  static constexpr unsigned kSubBucketBits{6};
+  static constexpr unsigned kMaxValueBits{36};
+  static constexpr std::size_t kSubBucketHalf{std::size_t{1} << (kSubBucketBits - 1)};
+  static constexpr std::size_t kBucketCount{(kMaxValueBits - kSubBucketBits + 2) * kSubBucketHalf};
+  static constexpr std::uint64_t kMaxValue{(std::uint64_t{1} << kMaxValueBits) - 1};
+
+  /// Copy of the histogram at one point in time
+  struct Snapshot {
+    std::array<std::uint64_t, kBucketCount> counts{};  ///< Values per bucket
+    std::uint64_t count{0};                            ///< Number of values
+    Duration total{0};                                 ///< Sum of the values
+    Duration min{0};                                   ///< Smallest value, zero without values
+    Duration max{0};                                   ///< Largest value
+
+    /**
+     * @brief value below or at which the given fraction of the values lies
+     * @param quantile - fraction in [0, 1], e.g. 0.99 for the 99th percentile
+     * @return midpoint of the bucket of the quantile within [min, max], zero without values
+     */
+    [[nodiscard]] Duration percentile(double quantile) const;
+    [[nodiscard]] Duration mean() const {
+      return count != 0 ? total / static_cast<Duration::rep>(count) : Duration{0};
+    }
+    [[nodiscard]] Duration p50() const {
+      return percentile(0.5);
+    }
+    [[nodiscard]] Duration p99() const {
+      return percentile(0.99);
+    }
+    [[nodiscard]] Duration p999() const {
+      return percentile(0.999);
+    }
+  };
+
+  LatencyHistogram() = default;
+  virtual ~LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  /**
+   * @brief counts a value, negative values count as zero
+   */
+  void record(Duration value) noexcept {
+    const auto clamped = value.count() > 0 ? static_cast<std::uint64_t>(value.count()) : std::uint64_t{0};
+    const auto bounded = clamped < kMaxValue ? clamped : kMaxValue;
+    m_Counts[bucketOf(bounded)].fetch_add(1, std::memory_order_relaxed);
+    m_Total.fetch_add(clamped, std::memory_order_relaxed);
+    auto min = m_Min.load(std::memory_order_relaxed);
+    while (clamped < min && !m_Min.compare_exchange_weak(min, clamped, std::memory_order_relaxed)) {
+    }
+    auto max = m_Max.load(std::memory_order_relaxed);
+    while (clamped > max && !m_Max.compare_exchange_weak(max, clamped, std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief copies the histogram without stopping the recording threads
+   */
+  [[nodiscard]] Snapshot snapshot() const;
+
+  /**
+   * @brief drops all values, values recorded concurrently may partly survive
+   */
+  void reset() noexcept;
+
+  /**
+   * @brief bucket of a value not larger than kMaxValue
+   */
+  [[nodiscard]] static constexpr std::size_t bucketOf(std::uint64_t value) noexcept {
+    if (value < (std::uint64_t{1} << kSubBucketBits)) {
+      return static_cast<std::size_t>(value);
+    }
+    const auto shift = static_cast<unsigned>(std::bit_width(value)) - kSubBucketBits;
+    return (shift + 1) * kSubBucketHalf + static_cast<std::size_t>(value >> shift) - kSubBucketHalf;
+  }
+  /**
+   * @brief smallest value of a bucket
+   */
+  [[nodiscard]] static constexpr std::uint64_t lowestValueOf(std::size_t bucket) noexcept {
+    if (bucket < (std::size_t{1} << kSubBucketBits)) {
+      return bucket;
+    }
+    const auto shift = bucket / kSubBucketHalf - 1;
+    return static_cast<std::uint64_t>(bucket % kSubBucketHalf + kSubBucketHalf) << shift;
+  }
+  /**
+   * @brief number of values falling into a bucket
+   */
+  [[nodiscard]] static constexpr std::uint64_t widthOf(std::size_t bucket) noexcept {
+    return bucket < (std::size_t{1} << kSubBucketBits) ? 1 : std::uint64_t{1} << (bucket / kSubBucketHalf - 1);
+  }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, kBucketCount> m_Counts{};              ///< Values per bucket
+  std::atomic<std::uint64_t> m_Total{0};                                        ///< Sum of the values
+  std::atomic<std::uint64_t> m_Min{std::numeric_limits<std::uint64_t>::max()};  ///< Smallest value
+  std::atomic<std::uint64_t> m_Max{0};                                          ///< Largest value
+};
+
+/**
+ * @brief Timing histograms of the callbacks of a scheduler or of a single event.
+ */
+struct LatencyHistograms {
+  LatencyHistogram lateness;    ///< From the deadline to the start of the callback
+  LatencyHistogram execution;   ///< Runtime of the callback
+  LatencyHistogram startDelay;  ///< Lateness of the start callbacks after the start delay
+
+  /**
+   * @brief counts the timing of one callback
+   * @param startCallback - start callback after a start delay, its lateness is the start-delay error
+   */
+  void recordCallback(LatencyHistogram::Duration latenessValue, LatencyHistogram::Duration executionValue,
+                      bool startCallback) noexcept {
+    lateness.record(latenessValue);
+    execution.record(executionValue);
+    if (startCallback) {
+      startDelay.record(latenessValue);
+    }
+  }
+};
+
+}  // end of namespace tev
@@ -0,0 +1,202 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains lock-free multi-producer single-consumer queue.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "slabPool.hpp"
+
+namespace tev {
+
+/**
+ * @brief Intrusive multi-producer single-consumer queue after Dmitry Vyukov.
+ *
+ * push() is wait-free: one atomic exchange and one store, independent of the number of producers
+ * and of what the consumer is doing. pop() must only be called by one thread at a time. While a
+ * producer is between its exchange and its store, pop() may report the queue empty although later
+ * items exist; the producer is expected to signal the consumer after push() returned.
+ *
+ * Nodes come from a SlabPool, so a queue in steady state does not touch the system allocator. The pool
+ * keeps its chunks until the queue is destroyed, so it is limited to the pooledNodes of the constructor;
+ * while more values are queued the excess nodes are allocated with new and freed again by pop(). The
+ * queue is therefore only bounded by the system memory, its retained memory by pooledNodes.
+ *
+ * @tparam T - value type, default constructible and movable
+ */
+template <class T>
+class MpscQueue {
+  struct Node;
+
+ public:
+  /**
+   * @brief Values linked up by one producer, appended by push(Batch&) with a single exchange.
+   */
+  class Batch {
+   public:
+    explicit Batch(MpscQueue& queue) : m_Queue(queue) {}
+    ~Batch() {
+      // values which were never pushed
+      while (m_First != nullptr) {
+        Node* next = m_First->next.load(std::memory_order_relaxed);
+        m_Queue.freeNode(m_First);
+        m_First = next;
+      }
+    }
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    void add(T value) {
+      Node* node = m_Queue.allocateNode(std::move(value));
+      if (m_Last == nullptr) {
+        m_First = node;
+      } else {
+        m_Last->next.store(node, std::memory_order_relaxed);
+      }
+      m_Last = node;
+    }
+    [[nodiscard]] bool empty() const {
+      return m_First == nullptr;
+    }
+
+   private:
+    friend class MpscQueue;
+    MpscQueue& m_Queue;      ///< Queue the nodes are allocated from
+    Node* m_First{nullptr};  ///< Oldest value
+    Node* m_Last{nullptr};   ///< Newest value
+  };
+
+  /// Nodes kept for reuse by default, 64k nodes retain a few MiB for small values
+  static constexpr std::size_t kPooledNodes{std::size_t{1} << 16};
+
+  /**
+   * @param pooledNodes - nodes kept for reuse, further nodes are allocated with new
+   */
+  explicit MpscQueue(std::size_t pooledNodes = kPooledNodes)
+      : m_Nodes(sizeof(Node), pooledNodes), m_Head(&m_Stub), m_Tail(&m_Stub) {}
+  virtual ~MpscQueue() {
+    T value;
+    while (pop(value)) {
+    }
+  }
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /**
+   * @brief append a value, callable from any thread
+   * @param value - value to append
+   */
+  void push(T value) {
+    pushNode(allocateNode(std::move(value)));
+  }
+
+  /**
+   * @brief append all values of a batch in their order, callable from any thread
+   * @details The batch is empty afterwards. Values of other producers never interleave with it.
+   */
+  void push(Batch& batch) {
+    if (batch.empty()) {
+      return;
+    }
+    // the release store publishes the links of the whole chain
+    Node* previous = m_Head.exchange(batch.m_Last, std::memory_order_acq_rel);
+    previous->next.store(batch.m_First, std::memory_order_release);
+    batch.m_First = nullptr;
+    batch.m_Last = nullptr;
+  }
+
+  /**
+   * @brief allocates the nodes for at least count queued values, up to the pooled nodes
+   */
+  void reserve(std::size_t count) {
+    m_Nodes.reserve(count);
+  }
+
+  /**
+   * @brief remove the oldest value, consumer thread only
+   * @param value - receives the value
+   * @return false if the queue is empty or the next value is not published yet
+   */
+  bool pop(T& value) {
+    Node* tail = m_Tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &m_Stub) {
+      if (next == nullptr) {
+        return false;
+      }
+      m_Tail = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      return take(tail, next, value);
+    }
+    if (tail != m_Head.load(std::memory_order_acquire)) {
+      // a producer has exchanged the head but not linked its node yet
+      return false;
+    }
+    // re-insert the stub behind the last node so the last node can be taken
+    pushNode(&m_Stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      return take(tail, next, value);
+    }
+    return false;
+  }
+
+ private:
+  struct Node {
+    T value;                           ///< Stored value
+    std::atomic<Node*> next{nullptr};  ///< Next newer node
+    bool pooled{true};                 ///< Node is a block of m_Nodes, else allocated with new
+  };
+
+  Node* allocateNode(T&& value) {
+    static_assert(alignof(Node) <= SlabPool::kAlignment);
+    if (void* block = m_Nodes.tryAllocate()) {
+      return new (block) Node{std::move(value)};
+    }
+    return new Node{std::move(value), nullptr, false};
+  }
+
+  void freeNode(Node* node) noexcept {
+    if (node->pooled) {
+      node->~Node();
+      m_Nodes.deallocate(node);
+    } else {
+      delete node;
+    }
+  }
+
+  void pushNode(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = m_Head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  bool take(Node* tail, Node* next, T& value) {
+    m_Tail = next;
+    value = std::move(tail->value);
+    freeNode(tail);
+    return true;
+  }
+
+  SlabPool m_Nodes{sizeof(Node)};         ///< Storage of the queued nodes
+  Node m_Stub;                            ///< Placeholder node, never holds a value
+  alignas(64) std::atomic<Node*> m_Head;  ///< Newest node, exchanged by the producers
+  alignas(64) Node* m_Tail;               ///< Oldest node, owned by the consumer
+};
+
+}  // end of namespace tev
@@ -13,16 +13,38 @@
 //-----------------------------------------------------------------------------
 // includes "..."
 //-----------------------------------------------------------------------------
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <chrono>
-#include <condition_variable>
-#include <list>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
 #include <thread>
+#include <unordered_set>
+#include <vector>
 
+#include "clock.hpp"
 #include "event.hpp"
+#include "eventHandleTable.hpp"
+#include "eventHeap.hpp"
+#include "eventTracer.hpp"
+#include "iEventQueue.hpp"
 #include "iController.hpp"
 #include "iUserData.hpp"
+#include "ioUringWaiter.hpp"
+#include "latencyHistogram.hpp"
+#include "schedulerMetrics.hpp"
+#include "mpscQueue.hpp"
+#include "slabPool.hpp"
+#include "strandExecutor.hpp"
+#include "timerFd.hpp"
+#include "typedEventConfig.hpp"
+#include "wakeSignal.hpp"
+#include "workerPool.hpp"
 
 namespace tev {
 
@@ -31,7 +53,7 @@ namespace tev {
  */
 class Event;
 using EventPtr = std::shared_ptr<Event>;
-using DurationUnit = std::chrono::milliseconds;
+using DurationUnit = std::chrono::nanoseconds;
 using namespace std::chrono_literals;
 
 /**
@@ -41,33 +63,250 @@ using namespace std::chrono_literals;
  * of tasks. It is designed to handle concurrency and ensure that tasks
  * are executed at the appropriate time intervals or deadlines. It supports
  * delayed execution, periodic tasks.
+ *
+ * Events are kept in a deadline-ordered queue, so a processing pass only touches
+ * events which are due. The queue is either a heap with exact ordering or a
+ * hierarchical timing wheel for large numbers of coarse-grained timeouts.
+ *
+ * Callbacks run either inline on the scheduler thread or on a pool of worker
+ * threads. In the pool mode an event is taken out of the queue while its callback
+ * runs and is re-armed by the worker afterwards, so callbacks of one event never
+ * overlap and a slow callback does not hold the scheduler lock. The strand mode
+ * additionally serializes all callbacks of events sharing the same controller.
+ *
+ * pushEvent() and eraseEvent() do not take the scheduler lock. They append a command
+ * to a lock-free queue which the processing pass applies before it looks for due
+ * events, so producers never wait for a pass or for each other. The scheduler thread
+ * is only woken when a push is due before the deadline it sleeps until, erases wait
+ * for the next pass, and without events the thread sleeps until a push arrives.
+ * pushEvents() and eraseEvents() append a whole batch at once and wake the thread at most once.
+ *
+ * Periodic events are served against absolute deadlines, start deadline plus a whole
+ * number of periods, so the phase does not drift with the scheduling latency. Periods
+ * which elapsed entirely before the event was served are handled by its CatchUpPolicy.
+ * Events with a slack may fire up to the slack late, their deadlines are moved to
+ * points in time shared with other events so that one wake-up serves them together.
+ *
+ * Events due in the same pass are served by priority class and by earliest deadline
+ * within a class, the lateness of the callbacks is measured per priority.
+ *
+ * Instead of running its own thread the scheduler can be embedded into an external
+ * epoll or asio loop: with Config::timerFd it keeps a timerfd armed to the earliest
+ * deadline, the loop watches getTimerFd() and calls processDue() when it is readable.
+ *
+ * Every push yields an EventHandle. Cancelling and querying by handle costs O(1)
+ * from any thread, handles of events which left the scheduler are detected as stale.
  */
 class Scheduler {
  public:
   static constexpr DurationUnit kMaxDelayIntervalMs{5000ms};
 
-  Scheduler() = default;
+  /// Queue used to order the scheduled events
+  enum class QueueMode {
+    Heap,        ///< 4-ary min-heap, exact deadline order, O(log n) insert and cancel
+    TimingWheel  ///< hierarchical timing wheel, ticks of Config::wheelResolution, O(1) insert and cancel
+  };
+
+  /// Threads on which the event callbacks run
+  enum class ExecutionMode {
+    Inline,  ///< on the scheduler thread while the due events are processed
+    Pool,    ///< on a pool of worker threads, the scheduler thread only determines what is due
+    Strand   ///< on a pool of worker threads, callbacks of the same controller one at a time in order
+  };
+
+  /// Memory of the events created by pushEvent(controller, userData, config)
+  enum class EventStorage {
+    Heap,  ///< one system allocation per event
+    Slab   ///< blocks of a pool owned by the scheduler, no system allocation once reserved
+  };
+
+  /// Wait of the scheduler thread between two passes, trades CPU time for wake-up accuracy
+  enum class WaitStrategy {
+    Sleep,          ///< condition variable until the next deadline, woken by pushes due earlier
+    SleepUntil,     ///< clock_nanosleep to the absolute next deadline, pushes are noticed at the next pass
+    SleepThenSpin,  ///< condition variable until spinThreshold before the deadline, then busy-wait
+    BusyPoll,       ///< busy-wait for the deadline or a wake-up, occupies one core
+    IoUring         ///< io_uring timeout at the deadline and eventfd wake-ups, Sleep without io_uring
+  };
+
+  /// Construction parameters of a scheduler
+  struct Config {
+    QueueMode queueMode{QueueMode::Heap};                ///< Queue used to order the events
+    ExecutionMode executionMode{ExecutionMode::Inline};  ///< Threads running the callbacks
+    std::size_t workerThreads{0};                        ///< Pool size, 0 for the number of hardware threads
+    EventStorage eventStorage{EventStorage::Heap};       ///< Memory of the created events
+    WaitStrategy waitStrategy{WaitStrategy::Sleep};      ///< Wait of the scheduler thread between passes
+    DurationUnit spinThreshold{50us};                    ///< Busy-wait before a deadline in SleepThenSpin
+    DurationUnit wheelResolution{1ms};                   ///< Tick of the timing wheel queue
+    bool timerFd{false};                                 ///< Arm a timerfd for an external loop, see getTimerFd()
+    int cpu{-1};                                         ///< CPU the scheduler thread is pinned to, -1 for none
+    std::size_t traceCapacity{0};                        ///< Trace records per thread, 0 disables the tracer
+    std::shared_ptr<IClock> clock{};                     ///< Time of the deadlines, nullptr for steady_clock
+    std::uint32_t handleTag{0};                          ///< Upper bits of the handles, up to EventHandleTable::kMaxTag
+  };
+
+  /// Lateness of the callbacks of one priority, from the deadline to the start of the callback
+  struct LatenessStats {
+    std::uint64_t callbacks{0};  ///< Number of measured callbacks
+    DurationUnit total{0};       ///< Sum of the lateness of all callbacks
+    DurationUnit max{0};         ///< Largest lateness
+
+    [[nodiscard]] DurationUnit mean() const {
+      return callbacks != 0 ? total / static_cast<DurationUnit::rep>(callbacks) : DurationUnit{0};
+    }
+  };
+
+  explicit Scheduler(QueueMode queueMode = QueueMode::Heap);
+  explicit Scheduler(const Config& config);
   virtual ~Scheduler() = default;
   Scheduler(const Scheduler&) = delete;
   Scheduler& operator=(const Scheduler&) = delete;
 
-  [[nodiscard]] DurationUnit processEvents(std::chrono::milliseconds processingTime);
+  /**
+   * @brief serves the due events
+   * @param processingTime - longest wait to return
+   * @return time until the earliest deadline, at most processingTime, zero if an event is due already
+   */
+  [[nodiscard]] DurationUnit processEvents(DurationUnit processingTime);
+
+  /**
+   * @brief serves the due events when the scheduler is driven by an external event loop
+   * @details Call when getTimerFd() is readable. Consumes the expiration and re-arms the timerfd
+   * to the earliest deadline, or leaves it disarmed while no event is scheduled.
+   */
+  void processDue();
 
-  void pushEvent(std::shared_ptr<Event> event);
-  [[nodiscard]] std::shared_ptr<Event> pushEvent(std::shared_ptr<IController> controller,
-                                                 std::shared_ptr<IUserData> userData, const EventConfig& config);
+  /**
+   * @brief descriptor which becomes readable when processDue() has work
+   * @details Readable at the earliest armed deadline and when a push or a re-arm from a worker
+   * thread moves that deadline earlier, so it can be added to an epoll set or an asio loop instead
+   * of running start(). Erases do not make it readable, the next pass applies them.
+   * @return the timerfd, -1 if Config::timerFd is not set or the system has no timerfd
+   */
+  [[nodiscard]] int getTimerFd() const {
+    return m_TimerFd ? m_TimerFd->getFd() : -1;
+  }
+
+  /**
+   * @brief schedules an event or restarts a scheduled one
+   * @return handle of this push, live from now on even if an erase of the event is still pending
+   * @details Every push acquires a handle of its own, which getHandle() of the event returns. The
+   * pass applying the push turns the handle of an earlier push of the event stale.
+   */
+  EventHandle pushEvent(std::shared_ptr<Event> event);
+  [[nodiscard]] std::shared_ptr<Event> pushEvent(const std::shared_ptr<IController>& controller,
+                                                 const std::shared_ptr<IUserData>& userData,
+                                                 const EventConfig& config);
 
+  /**
+   * @brief creates and schedules an event whose callbacks receive the typed controller and user data
+   * @param controller - controller of the event, not nullptr
+   * @param userData - user data of the event, not nullptr
+   */
+  template <class TController, class TUserData>
+  [[nodiscard]] std::shared_ptr<Event> pushEvent(const std::shared_ptr<TController>& controller,
+                                                 const std::shared_ptr<TUserData>& userData,
+                                                 const TypedEventConfig<TController, TUserData>& config) {
+    // the callbacks dereference both without checking
+    assert(controller && userData);
+    return pushEvent(std::static_pointer_cast<IController>(controller), std::static_pointer_cast<IUserData>(userData),
+                     config.getConfig());
+  }
+
+  /**
+   * @brief schedules or restarts events like pushEvent() one by one
+   * @details The events are submitted as one batch with one clock read, and the scheduler thread
+   * is woken at most once, for the earliest first deadline. nullptr events are skipped.
+   * @return number of submitted events
+   */
+  std::size_t pushEvents(std::span<const std::shared_ptr<Event>> events);
+
+  /**
+   * @brief creates and schedules an event per config, all with the same controller and user data
+   * @return the events in the order of the configs
+   */
+  [[nodiscard]] std::vector<std::shared_ptr<Event>> pushEvents(const std::shared_ptr<IController>& controller,
+                                                               const std::shared_ptr<IUserData>& userData,
+                                                               std::span<const EventConfig> configs);
+
+  /**
+   * @brief prepares storage for count events
+   * @details Allocates the slab chunks in the slab storage mode, the queue storage and the
+   * submission queue nodes, so pushing, firing and erasing up to count events does not
+   * allocate afterwards. The submission queue keeps at most MpscQueue::kPooledNodes nodes,
+   * commands beyond those pending between two passes are allocated one by one.
+   */
+  void reserve(std::size_t count);
+
+  /**
+   * @brief removes events from the scheduler
+   * @details Applied by the next processing pass. A callback which already runs finishes,
+   * no further callback of the erased events is invoked once the next pass started.
+   */
   void eraseEvent(std::shared_ptr<Event> event);
   void eraseEvent(std::shared_ptr<IUserData> userData);
 
+  /**
+   * @brief removes events like eraseEvent() one by one, submitted as one batch without a wake-up
+   */
+  void eraseEvents(std::span<const std::shared_ptr<Event>> events);
+
+  /**
+   * @brief removes the event of a handle, applied by the next pass like eraseEvent()
+   * @return false if the handle is stale
+   */
+  bool cancelEvent(const EventHandle& handle);
+
+  /**
+   * @brief status of the event of a handle after the last pass
+   * @return nothing if the handle is stale, i.e. the event finished or was erased
+   */
+  [[nodiscard]] std::optional<Event::Status> getEventStatus(const EventHandle& handle) const {
+    return m_Handles.getStatus(handle);
+  }
+
+  /**
+   * @brief checks whether the event is scheduled by this scheduler, callable from any thread
+   * @details True from the push of the event until it finished or was erased.
+   */
+  [[nodiscard]] bool owns(const Event& event) const {
+    return m_Handles.get(event.getHandle()) == &event;
+  }
+
+  /**
+   * @brief starts the scheduler thread
+   * @details A scheduler on a clock which is not real time, like ManualClock, has no thread, it is
+   * driven by processEvents() while the clock is advanced.
+   * @return false if it runs already, could not be pinned to Config::cpu or its clock is not real time
+   */
   bool start();
 
+  /**
+   * @brief makes the scheduler thread run a pass now
+   * @details Pushes only call this when the new event is due before the current sleep deadline.
+   */
   void wakeUp() {
-    m_CondEvent.notify_all();
+    m_Wake.notify();
+    if (m_Ring) {
+      m_Ring->wake();
+    }
+    // one readable timerfd per pass is enough
+    if (m_TimerFd && !m_TimerFdWake.exchange(true, std::memory_order_acq_rel)) {
+      m_TimerFd->armNow();
+    }
   }
 
   void terminate();
+  /**
+   * @brief stops the scheduler thread and waits for it to end, start() may be called again afterwards
+   * @details Must not be called from a callback on the scheduler thread.
+   */
+  void stop();
 
+  /**
+   * @brief longest sleep of the SleepUntil strategy, which cannot be woken by pushes
+   * @details The other strategies sleep until the earliest deadline, without events until a push.
+   */
   [[nodiscard]] DurationUnit getMaxInterval() const {
     return m_MaxInterval;
   }
@@ -75,17 +314,204 @@ class Scheduler {
     m_MaxInterval = maxInterval;
   }
 
-  [[nodiscard]] auto getEventsCount() const {
-    return m_scheduledEvents.size();
+  /**
+   * @brief number of scheduled events
+   * @details Counts the events known after the last pass plus the pushes not applied yet.
+   */
+  [[nodiscard]] std::size_t getEventsCount() const {
+    return m_EventsCount.load(std::memory_order_acquire) + m_PendingPushes.load(std::memory_order_acquire);
+  }
+  /**
+   * @brief number of processing passes run so far, every wake-up of the scheduler thread runs one
+   */
+  [[nodiscard]] std::uint64_t getPassCount() const {
+    return m_PassCount.load(std::memory_order_relaxed);
+  }
+  /**
+   * @brief number of periods dropped by the catch-up policies of all events
+   */
+  [[nodiscard]] std::uint64_t getMissedPeriods() const {
+    return m_MissedPeriods.load(std::memory_order_relaxed);
+  }
+  /**
+   * @brief lateness of the callbacks of events with the given priority since construction
+   * @details Includes the slack of coalesced events and the time spent on callbacks served earlier
+   * in the same pass, which is what the priority classes reduce for the important events.
+   */
+  [[nodiscard]] LatenessStats getLateness(Priority priority) const;
+  /**
+   * @brief timing histograms of all callbacks since construction
+   * @details Recorded by the scheduler thread and the workers without a lock, take snapshot() of a
+   * histogram for its percentiles while the scheduler runs.
+   */
+  [[nodiscard]] const LatencyHistograms& getLatencyHistograms() const {
+    return m_Latency;
+  }
+  /**
+   * @brief tracer of lifecycle transitions, callbacks and waits, see EventTracer::writeChromeTrace()
+   * @return nullptr unless Config::traceCapacity is set
+   */
+  [[nodiscard]] const EventTracer* getTracer() const {
+    return m_Tracer.get();
+  }
+  /**
+   * @brief counters and gauges of passes, events, lock times and wake-ups, readable while the scheduler runs
+   */
+  [[nodiscard]] SchedulerMetrics getMetrics() const;
+  [[nodiscard]] QueueMode getQueueMode() const {
+    return m_Config.queueMode;
+  }
+  [[nodiscard]] ExecutionMode getExecutionMode() const {
+    return m_Config.executionMode;
+  }
+  /**
+   * @brief wait strategy in use, Sleep if IoUring was configured but io_uring is not available
+   */
+  [[nodiscard]] WaitStrategy getWaitStrategy() const {
+    return m_Config.waitStrategy;
+  }
+  [[nodiscard]] EventStorage getEventStorage() const {
+    return m_Config.eventStorage;
+  }
+  /**
+   * @brief pool of the event slab storage, nullptr in the heap storage mode
+   */
+  [[nodiscard]] const std::shared_ptr<SlabPool>& getEventPool() const {
+    return m_EventPool;
+  }
+  /**
+   * @brief clock the deadlines of the scheduler and of its events refer to
+   */
+  [[nodiscard]] const IClock& getClock() const {
+    return *m_Clock;
   }
 
  private:
-  std::mutex m_Mutex;                                   ///< Protects access to shared resources
-  std::mutex m_CondMutex;                               ///< Guards condition variable synchronization
-  std::condition_variable m_CondEvent;                  ///< Notifies scheduler thread of events or termination
-  std::list<std::shared_ptr<Event>> m_scheduledEvents;  ///< Stores scheduled events
-  std::jthread m_Thread;                                ///< Runs the event scheduler's service loop
-  DurationUnit m_MaxInterval{kMaxDelayIntervalMs};      ///< Max interval for event processing
+  using TimePoint = std::chrono::steady_clock::time_point;
+  /// Room for an event and the shared_ptr control block allocate_shared puts it in, a block too
+  /// small would silently send every event to the heap. Unknown libraries get a generous estimate.
+#if defined(__GLIBCXX__)
+  static constexpr std::size_t kEventBlockSize{
+      sizeof(std::_Sp_counted_ptr_inplace<Event, SlabAllocator<Event>, __gnu_cxx::__default_lock_policy>)};
+#elif defined(_LIBCPP_VERSION)
+  static constexpr std::size_t kEventBlockSize{sizeof(std::__shared_ptr_emplace<Event, SlabAllocator<Event>>)};
+#else
+  static constexpr std::size_t kEventBlockSize{sizeof(Event) + 8 * sizeof(void*)};
+#endif
+
+  /// Due event of a pass at its position in the serving order
+  struct DueEntry {
+    Priority priority{Priority::Normal};  ///< Priority class, served first
+    TimePoint deadline{};                 ///< Deadline the event is served for, earliest first
+    std::size_t index{0};                 ///< Position in m_DueEvents
+  };
+
+  /// Lateness counters of one priority, updated by the scheduler thread and the workers
+  struct LatenessCounters {
+    std::atomic<std::uint64_t> callbacks{0};  ///< Number of measured callbacks
+    std::atomic<DurationUnit::rep> total{0};  ///< Sum of the lateness
+    std::atomic<DurationUnit::rep> max{0};    ///< Largest lateness
+  };
+
+  /// Counters behind getMetrics(), written by the passes unless noted
+  struct MetricCounters {
+    std::atomic<std::uint64_t> idlePasses{0};         ///< Passes which invoked no callback
+    std::atomic<std::uint64_t> callbacks{0};          ///< Callbacks invoked or dispatched
+    std::atomic<std::uint64_t> pushes{0};             ///< Applied pushes
+    std::atomic<std::uint64_t> erases{0};             ///< Events removed by erases
+    std::atomic<std::uint64_t> cancels{0};            ///< Events removed by cancels
+    std::atomic<std::uint64_t> completed{0};          ///< Events finished in status Completed
+    std::atomic<std::uint64_t> aborted{0};            ///< Events finished in status Aborted
+    std::atomic<std::uint64_t> timedOut{0};           ///< Events finished in status Timeouted
+    std::atomic<DurationUnit::rep> lockWait{0};       ///< Time spent waiting for m_Mutex
+    std::atomic<DurationUnit::rep> lockWaitMax{0};    ///< Longest wait for m_Mutex
+    std::atomic<DurationUnit::rep> lockHold{0};       ///< Time m_Mutex was held by passes
+    std::atomic<DurationUnit::rep> lockHoldMax{0};    ///< Longest hold of m_Mutex by a pass
+    std::atomic<std::uint64_t> deadlineWakeUps{0};    ///< Waits ended by their deadline, scheduler thread
+    std::atomic<std::uint64_t> notifiedWakeUps{0};    ///< Waits ended by a wake-up, scheduler thread
+    std::atomic<std::uint64_t> pushWakeRequests{0};   ///< Wake-ups by pushes, any thread
+    std::atomic<std::uint64_t> rearmWakeRequests{0};  ///< Wake-ups by re-arms, worker threads
+    std::atomic<std::size_t> maxQueueDepth{0};        ///< Largest queue size after a pass
+    std::atomic<std::size_t> inFlight{0};             ///< In-flight events after the last pass
+  };
+
+  /// Request to the processing pass, submitted without taking the scheduler lock
+  struct Command {
+    enum class Kind {
+      Push,           ///< schedule or restart event
+      EraseEvent,     ///< remove event
+      EraseUserData,  ///< remove all events of userData
+      Cancel,         ///< remove event of handle
+      Rearm           ///< callback of event returned on a worker thread
+    };
+    Kind kind{Kind::Push};                  ///< Requested operation
+    EventPtr event{};                       ///< Event of Push, EraseEvent and Rearm
+    std::shared_ptr<IUserData> userData{};  ///< User data of EraseUserData
+    TimePoint timePoint{};                  ///< Submission time
+    bool finished{false};                   ///< Rearm of an event in a final state
+    EventHandle handle{};                   ///< Handle of Push and Cancel
+  };
+
+  bool waitForPass(WakeSignal::Token token, TimePoint deadline, const std::stop_token& stopToken);
+  bool spinUntil(WakeSignal::Token token, TimePoint deadline, const std::stop_token& stopToken);
+  std::optional<TimePoint> runPass();
+  void submitCommand(Command command, TimePoint deadline);
+  void wakeForCommand(Command::Kind kind, TimePoint deadline);
+  EventPtr makeEvent(const std::shared_ptr<IController>& controller, const std::shared_ptr<IUserData>& userData,
+                     const EventConfig& config);
+  std::size_t applyCommands();
+  void armEvent(EventPtr event, const EventHandle& handle, TimePoint now);
+  bool removeEvent(Event& event);
+  void recordLock(DurationUnit wait, DurationUnit hold);
+  [[nodiscard]] static TimePoint serviceDeadline(Event& event, TimePoint now);
+  [[nodiscard]] static TimePoint nextDeadline(Event& event, TimePoint now);
+  [[nodiscard]] static TimePoint firstDeadline(Event& event, TimePoint now);
+  [[nodiscard]] static TimePoint coalesce(TimePoint deadline, DurationUnit slack);
+  [[nodiscard]] static bool hasLifeDeadline(Event& event);
+  void advancePeriod(Event& event, TimePoint now);
+  void sortDueEvents(TimePoint now);
+  [[nodiscard]] TimePoint currentTime() const noexcept {
+    return m_Clock->now();
+  }
+  [[nodiscard]] TimePoint steadyDeadline(TimePoint deadline) const noexcept;
+  TimePoint invokeCallback(const EventPtr& event, ControllerEventCallback* callback, TimePoint deadline,
+                           TimePoint start);
+  void setStatus(Event& event, Event::Status status);
+  [[nodiscard]] static EventTracer::Callback callbackOf(Event& event, const ControllerEventCallback* callback);
+  void recordTimes(Event& event, DurationUnit lateness, DurationUnit execution, bool startCallback);
+  void rescheduleEvent(EventPtr event, TimePoint now);
+  void dispatchCallback(EventPtr event, ControllerEventCallback* callback, bool finished, TimePoint deadline);
+  void completeCallback(EventPtr event, bool finished);
+  void finishCallback(EventPtr event, bool finished, TimePoint now);
+
+  std::mutex m_Mutex;                                        ///< Protects access to shared resources
+  WakeSignal m_Wake;                                         ///< Wakes the scheduler thread
+  std::atomic<TimePoint> m_SleepDeadline{TimePoint::max()};  ///< Deadline of the next pass, max() while unknown
+  Config m_Config;                                           ///< Construction parameters
+  std::shared_ptr<IClock> m_Clock;                           ///< Source of the current time
+  std::shared_ptr<SlabPool> m_EventPool;                     ///< Event storage in the slab mode
+  std::unique_ptr<IEventQueue> m_scheduledEvents;            ///< Stores scheduled events ordered by deadline
+  std::vector<EventPtr> m_DueEvents;                         ///< Events taken from the heap in the current pass
+  std::vector<DueEntry> m_DueOrder;                          ///< Serving order of m_DueEvents, priority then deadline
+  std::unordered_set<Event*> m_InFlight;                     ///< Events whose callback is queued or running in the pool
+  EventHandleTable m_Handles;                                ///< Resolves event handles
+  MpscQueue<Command> m_Commands;                             ///< Pushes, erases and re-arms for the next pass
+  std::atomic<std::size_t> m_PendingPushes{0};               ///< Push commands not applied yet
+  std::atomic<std::size_t> m_EventsCount{0};                 ///< Queued and in-flight events after the last pass
+  std::atomic<std::uint64_t> m_MissedPeriods{0};             ///< Periods dropped by the catch-up policies
+  std::atomic<std::uint64_t> m_PassCount{0};                 ///< Processing passes run
+  std::array<LatenessCounters, kPriorityLevels> m_Lateness;  ///< Callback lateness per priority
+  LatencyHistograms m_Latency;                               ///< Callback timing histograms
+  std::unique_ptr<EventTracer> m_Tracer;                     ///< Trace records, only with Config::traceCapacity
+  MetricCounters m_Metrics;                                  ///< Counters of getMetrics()
+  std::unique_ptr<TimerFd> m_TimerFd;                        ///< Wakes an external event loop
+  std::unique_ptr<IoUringWaiter> m_Ring;                     ///< Waits of the IoUring strategy
+  std::atomic<bool> m_TimerFdWake{false};                    ///< Timerfd armed for a wake-up since the last pass
+  // destroyed before the wake-ups above, the callbacks still draining wake the scheduler when they return
+  std::unique_ptr<StrandExecutor> m_Strands;                 ///< Serializes callbacks per controller in strand mode
+  std::unique_ptr<WorkerPool> m_Pool;                        ///< Runs the callbacks in the pool execution modes
+  std::jthread m_Thread;                                     ///< Runs the event scheduler's service loop
+  DurationUnit m_MaxInterval{kMaxDelayIntervalMs};           ///< Max interval for event processing
 };
 
 }  // end of namespace tev
@@ -0,0 +1,88 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the counters and gauges of a scheduler.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tev {
+
+/**
+ * @brief Counters and gauges of a scheduler at one point in time, taken with Scheduler::getMetrics().
+ *
+ * Counters count since the construction of the scheduler, gauges are the state after the last pass.
+ * Pushes and erases never take the scheduler lock, the lock times are the ones of the processing
+ * passes, a long lock wait means that a second thread drives passes or reserves storage. Producers
+ * are reflected by the pending pushes and by the wake-up requests instead.
+ *
+ * toPrometheus() renders the Prometheus text exposition format, toJson() a flat JSON object with
+ * the same names, and writeFile() replaces a file atomically, e.g. for the node_exporter textfile
+ * collector.
+ */
+struct SchedulerMetrics {
+  using Duration = std::chrono::nanoseconds;
+
+  /// Output format of writeFile()
+  enum class Format {
+    Prometheus,  ///< Prometheus text exposition format
+    Json         ///< one JSON object
+  };
+
+  std::uint64_t passes{0};             ///< Processing passes
+  std::uint64_t idlePasses{0};         ///< Passes which invoked no callback
+  std::uint64_t callbacks{0};          ///< Callbacks invoked inline or handed to the workers
+  std::uint64_t pushes{0};             ///< Applied pushes
+  std::uint64_t erases{0};             ///< Events removed by erases by event or by user data
+  std::uint64_t cancels{0};            ///< Events removed by cancels of their handle
+  std::uint64_t completed{0};          ///< Events finished in status Completed
+  std::uint64_t aborted{0};            ///< Events finished in status Aborted
+  std::uint64_t timedOut{0};           ///< Events finished in status Timeouted
+  std::uint64_t missedPeriods{0};      ///< Periods dropped by the catch-up policies
+  Duration lockWait{0};                ///< Time spent waiting for the scheduler lock
+  Duration lockWaitMax{0};             ///< Longest wait for the scheduler lock
+  Duration lockHold{0};                ///< Time the scheduler lock was held
+  Duration lockHoldMax{0};             ///< Longest hold of the scheduler lock
+  std::uint64_t deadlineWakeUps{0};    ///< Waits of the scheduler thread ended by their deadline
+  std::uint64_t notifiedWakeUps{0};    ///< Waits of the scheduler thread ended by a wake-up
+  std::uint64_t pushWakeRequests{0};   ///< Pushes due before the sleep deadline which woke the thread
+  std::uint64_t rearmWakeRequests{0};  ///< Re-arms from the workers which woke the thread
+  std::size_t events{0};               ///< Gauge: queued and in-flight events
+  std::size_t inFlight{0};             ///< Gauge: events whose callback runs on a worker
+  std::size_t pendingPushes{0};        ///< Gauge: pushes not applied yet
+  std::size_t maxQueueDepth{0};        ///< Largest number of queued events after a pass
+
+  /**
+   * @brief adds the metrics of another scheduler, e.g. of the shards of a ShardedScheduler
+   * @details Counters and gauges add up, maxima take the larger value.
+   */
+  SchedulerMetrics& operator+=(const SchedulerMetrics& other);
+
+  /**
+   * @brief metrics in the Prometheus text exposition format
+   * @param prefix - prefix of the metric names
+   */
+  [[nodiscard]] std::string toPrometheus(std::string_view prefix = "tev_scheduler") const;
+
+  /**
+   * @brief metrics as one JSON object, the keys are the Prometheus names without prefix
+   */
+  [[nodiscard]] std::string toJson() const;
+
+  /**
+   * @brief writes the metrics to a file, replaced atomically by a rename
+   * @return false if the file could not be written
+   */
+  bool writeFile(const std::string& path, Format format) const;
+};
+
+}  // end of namespace tev
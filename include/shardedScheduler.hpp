@@ -0,0 +1,184 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for scheduling events on several scheduler threads.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "event.hpp"
+#include "scheduler.hpp"
+
+namespace tev {
+
+/**
+ * @brief Handle of an event scheduled by a ShardedScheduler, the shard and the handle within it.
+ */
+struct ShardedHandle {
+  std::uint32_t shard{0};  ///< Index of the owning shard
+  EventHandle handle{};    ///< Handle within the shard
+
+  [[nodiscard]] bool valid() const noexcept {
+    return handle.valid();
+  }
+  friend bool operator==(const ShardedHandle&, const ShardedHandle&) = default;
+};
+
+/**
+ * @brief Runs independent schedulers, the shards, each with its own thread, queue and lock.
+ *
+ * Timer management of a single Scheduler is bound to its one thread. The sharded scheduler places
+ * every event on one of several shards, so the shards serve their events in parallel and the
+ * throughput grows with the number of cores. Each shard thread can be pinned to a CPU.
+ *
+ * The placement key of an event selects its shard: the controller, the user data, a key given to
+ * pushEvent() or a round-robin counter. Events sharing a key share a shard, so in the Strand execution
+ * mode the callbacks of a controller stay serialized with controller placement. A scheduled event is
+ * always pushed again to the shard owning it. Erasing and cancelling is routed to the owning shard,
+ * which the event handle tells, erasing by user data is applied by all shards.
+ */
+class ShardedScheduler {
+ public:
+  /// Selects the shard of a new event
+  enum class Placement {
+    Controller,  ///< hash of the controller, events of a controller share a shard
+    UserData,    ///< hash of the user data, events of a user data share a shard
+    RoundRobin   ///< one shard after the other
+  };
+
+  /// Construction parameters of a sharded scheduler
+  struct Config {
+    Scheduler::Config shard{};                   ///< Configuration of every shard, Config::cpu is taken from cpus
+    std::size_t shards{0};                       ///< Number of shards, 0 for the number of hardware threads
+    std::vector<int> cpus{};                     ///< CPU of shard i is cpus[i % cpus.size()], empty for no pinning
+    Placement placement{Placement::Controller};  ///< Shard of the events pushed without a key
+  };
+
+  explicit ShardedScheduler(const Config& config);
+  virtual ~ShardedScheduler() = default;
+  ShardedScheduler(const ShardedScheduler&) = delete;
+  ShardedScheduler& operator=(const ShardedScheduler&) = delete;
+
+  /**
+   * @brief schedules an event or restarts a scheduled one on the shard selected by the placement
+   */
+  ShardedHandle pushEvent(std::shared_ptr<Event> event);
+  /**
+   * @brief schedules an event on the shard of a key, events with the same key share a shard
+   * @details A scheduled event is restarted on the shard owning it regardless of the key.
+   */
+  ShardedHandle pushEvent(std::uint64_t key, std::shared_ptr<Event> event);
+  [[nodiscard]] std::shared_ptr<Event> pushEvent(const std::shared_ptr<IController>& controller,
+                                                 const std::shared_ptr<IUserData>& userData,
+                                                 const EventConfig& config);
+
+  /**
+   * @brief creates and schedules an event whose callbacks receive the typed controller and user data
+   */
+  template <class TController, class TUserData>
+  [[nodiscard]] std::shared_ptr<Event> pushEvent(const std::shared_ptr<TController>& controller,
+                                                 const std::shared_ptr<TUserData>& userData,
+                                                 const TypedEventConfig<TController, TUserData>& config) {
+    assert(controller && userData);
+    return pushEvent(std::static_pointer_cast<IController>(controller), std::static_pointer_cast<IUserData>(userData),
+                     config.getConfig());
+  }
+
+  /**
+   * @brief removes an event from its shard, events not scheduled are ignored
+   */
+  void eraseEvent(const std::shared_ptr<Event>& event);
+  /**
+   * @brief removes the events of a user data from all shards
+   */
+  void eraseEvent(const std::shared_ptr<IUserData>& userData);
+
+  /**
+   * @brief removes the event of a handle from its shard
+   * @return false if the handle is stale
+   */
+  bool cancelEvent(const ShardedHandle& handle);
+
+  /**
+   * @brief status of the event of a handle after the last pass of its shard
+   */
+  [[nodiscard]] std::optional<Event::Status> getEventStatus(const ShardedHandle& handle) const;
+
+  /**
+   * @brief prepares storage for count events spread over the shards
+   */
+  void reserve(std::size_t count);
+
+  /**
+   * @brief starts the threads of all shards
+   * @details If a shard fails to start or throws, the shards started before are stopped again, so
+   * either all shards run afterwards or none of those this call started.
+   * @return false if a shard runs already or could not be pinned to its CPU
+   */
+  bool start();
+  void terminate();
+
+  [[nodiscard]] std::size_t getShardCount() const {
+    return m_Shards.size();
+  }
+  [[nodiscard]] Scheduler& getShard(std::size_t index) {
+    return *m_Shards[index];
+  }
+  [[nodiscard]] const Scheduler& getShard(std::size_t index) const {
+    return *m_Shards[index];
+  }
+  /**
+   * @brief index of the shard an event is scheduled on, nothing if no shard owns it
+   * @details O(1), the handle tag of a shard is its index. Shards from EventHandleTable::kMaxTag on
+   * share the last tag and are searched one after the other.
+   */
+  [[nodiscard]] std::optional<std::size_t> findShard(const Event& event) const;
+
+  /**
+   * @brief number of scheduled events over all shards
+   */
+  [[nodiscard]] std::size_t getEventsCount() const;
+  /**
+   * @brief number of processing passes over all shards
+   */
+  [[nodiscard]] std::uint64_t getPassCount() const;
+  /**
+   * @brief number of periods dropped by the catch-up policies over all shards
+   */
+  [[nodiscard]] std::uint64_t getMissedPeriods() const;
+  /**
+   * @brief lateness of the callbacks of a priority over all shards
+   */
+  [[nodiscard]] Scheduler::LatenessStats getLateness(Priority priority) const;
+  /**
+   * @brief counters and gauges summed over all shards
+   */
+  [[nodiscard]] SchedulerMetrics getMetrics() const;
+  [[nodiscard]] Placement getPlacement() const {
+    return m_Placement;
+  }
+
+ private:
+  [[nodiscard]] std::size_t shardOfKey(std::uint64_t key) const;
+  [[nodiscard]] std::size_t placeShard(const IController* controller, const IUserData* userData);
+
+  std::vector<std::unique_ptr<Scheduler>> m_Shards;  ///< Independent schedulers
+  Placement m_Placement;                             ///< Shard of the events pushed without a key
+  std::atomic<std::size_t> m_NextShard{0};           ///< Round-robin index of the RoundRobin placement
+};
+
+}  // end of namespace tev
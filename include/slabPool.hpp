@@ -0,0 +1,160 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the fixed-size block pool.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace tev {
+
+/**
+ * @brief Lock-free pool of fixed-size memory blocks.
+ *
+ * Blocks are carved from chunks of kChunkBlocks blocks which are allocated on demand or up front by
+ * reserve() and only returned to the system when the pool is destroyed. Freed blocks go to a lock-free
+ * free list whose head carries a tag against ABA, so allocate() and deallocate() may be called from any
+ * thread and do not touch the system allocator once enough chunks exist.
+ */
+class SlabPool {
+ public:
+  static constexpr std::size_t kAlignment{16};
+  static constexpr std::uint32_t kChunkBits{10};
+  static constexpr std::uint32_t kChunkBlocks{1U << kChunkBits};
+  static constexpr std::uint32_t kMaxChunks{1U << 12};
+  static constexpr std::size_t kMaxBlocks{std::size_t{kMaxChunks} * kChunkBlocks};
+
+  /**
+   * @param blockSize - usable bytes per block
+   * @param maxBlocks - blocks the pool hands out at most, clamped to kMaxBlocks
+   */
+  explicit SlabPool(std::size_t blockSize, std::size_t maxBlocks = kMaxBlocks);
+  virtual ~SlabPool();
+  SlabPool(const SlabPool&) = delete;
+  SlabPool& operator=(const SlabPool&) = delete;
+
+  /**
+   * @brief takes a block of getBlockSize() bytes, aligned to kAlignment
+   * @throws std::bad_alloc if all getMaxBlocks() blocks are in use
+   */
+  [[nodiscard]] void* allocate();
+
+  /**
+   * @brief takes a block like allocate()
+   * @return nullptr if all getMaxBlocks() blocks are in use
+   */
+  [[nodiscard]] void* tryAllocate();
+
+  /**
+   * @brief returns a block taken by allocate() of this pool
+   */
+  void deallocate(void* block) noexcept;
+
+  /**
+   * @brief allocates the chunks for at least blocks blocks in use at the same time
+   */
+  void reserve(std::size_t blocks);
+
+  [[nodiscard]] std::size_t getBlockSize() const {
+    return m_BlockSize;
+  }
+  [[nodiscard]] std::size_t getMaxBlocks() const {
+    return m_MaxBlocks;
+  }
+  /**
+   * @brief number of blocks in use
+   */
+  [[nodiscard]] std::size_t getInUse() const {
+    return m_InUse.load(std::memory_order_relaxed);
+  }
+  /**
+   * @brief number of blocks in the allocated chunks
+   */
+  [[nodiscard]] std::size_t getCapacity() const {
+    return m_Chunks.load(std::memory_order_acquire) * static_cast<std::size_t>(kChunkBlocks);
+  }
+
+ private:
+  /// Precedes every block
+  struct Header {
+    std::uint32_t index;              ///< Block index in the pool
+    std::atomic<std::uint32_t> next;  ///< Next free block while on the free list
+  };
+  static constexpr std::size_t kHeaderSize{(sizeof(Header) + kAlignment - 1) / kAlignment * kAlignment};
+  static constexpr std::uint32_t kNoBlock{0xFFFFFFFFU};
+
+  static constexpr std::uint64_t pack(std::uint32_t index, std::uint32_t tag) {
+    return (static_cast<std::uint64_t>(tag) << 32) | index;
+  }
+
+  [[nodiscard]] Header* header(std::uint32_t index) const;
+  void ensureChunk(std::uint32_t chunk);
+
+  const std::size_t m_BlockSize;                              ///< Usable bytes per block
+  const std::size_t m_Stride;                                 ///< Distance of two blocks including the header
+  const std::size_t m_MaxBlocks;                              ///< Limit of the handed out blocks
+  std::array<std::atomic<std::byte*>, kMaxChunks> m_Slabs{};  ///< Chunks, allocated on demand
+  std::atomic<std::uint32_t> m_Chunks{0};                     ///< Number of allocated chunks
+  std::atomic<std::uint32_t> m_Next{0};                       ///< First block never handed out
+  std::atomic<std::uint64_t> m_FreeHead{pack(kNoBlock, 0)};   ///< Free list head and ABA tag
+  std::atomic<std::size_t> m_InUse{0};                        ///< Blocks handed out
+};
+
+/**
+ * @brief Allocator taking single objects which fit a block from a SlabPool.
+ *
+ * Used with std::allocate_shared, which co-allocates the control block with the object. Arrays and
+ * objects larger than a block fall back to std::allocator. The allocator keeps the pool alive, so
+ * objects may outlive the owner of the pool.
+ */
+template <class T>
+class SlabAllocator {
+ public:
+  using value_type = T;
+
+  explicit SlabAllocator(std::shared_ptr<SlabPool> pool) noexcept : m_Pool(std::move(pool)) {}
+  template <class U>
+  SlabAllocator(const SlabAllocator<U>& other) noexcept : m_Pool(other.getPool()) {}  // NOLINT: rebind
+
+  [[nodiscard]] T* allocate(std::size_t n) {
+    if (fits(n)) {
+      return static_cast<T*>(m_Pool->allocate());
+    }
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* object, std::size_t n) noexcept {
+    if (fits(n)) {
+      m_Pool->deallocate(object);
+    } else {
+      std::allocator<T>().deallocate(object, n);
+    }
+  }
+
+  [[nodiscard]] const std::shared_ptr<SlabPool>& getPool() const noexcept {
+    return m_Pool;
+  }
+
+  template <class U>
+  friend bool operator==(const SlabAllocator& lhs, const SlabAllocator<U>& rhs) noexcept {
+    return lhs.m_Pool == rhs.getPool();
+  }
+
+ private:
+  [[nodiscard]] bool fits(std::size_t n) const noexcept {
+    return n == 1 && sizeof(T) <= m_Pool->getBlockSize() && alignof(T) <= SlabPool::kAlignment;
+  }
+
+  std::shared_ptr<SlabPool> m_Pool;  ///< Pool of the blocks
+};
+
+}  // end of namespace tev
@@ -16,12 +16,14 @@ namespace tkcppsl::time {
 * @brief This is a easy stop timer in C++11 class.
 * Timer allows to set timeout and to check elapsed of timer
 *
+* The clock is a template parameter with a static now() like the std::chrono clocks, a test clock
+* can replace steady_clock. StartAt() takes the start point from the caller instead of the clock.
 */
-template <class TDuration = std::chrono::milliseconds>
+template <class TDuration = std::chrono::milliseconds, class TClock = std::chrono::steady_clock>
 class StopTimer {
  public:
   /** types */
-  using Clock = std::chrono::steady_clock;
+  using Clock = TClock;
   using TimePoint = std::chrono::time_point<StopTimer::Clock, TDuration>;
 
   /**
@@ -101,6 +103,23 @@ class StopTimer {
     return m_start_point;
   }
 
+  /**
+   * @brief start timer at a given start point with setup timeout
+   * @details restarting a periodic timer at its previous deadline keeps the phase, the time spent
+   * between the deadline and the restart does not accumulate
+   * @tparam TUnit - duration unit
+   * @param start_point - new start point, may lie in the past
+   * @param new_timeout - new timeout in duration unit
+   * @return start time point
+   */
+  template <typename TUnit = TDuration>
+  TimePoint StartAt(TimePoint start_point, TUnit new_timeout) noexcept {
+    SetTimeout<TUnit>(new_timeout);
+    m_is_running = true;
+    m_start_point = start_point;
+    return m_start_point;
+  }
+
   /**
    * @brief is a timeout interval elapsed
    * @brief check that a defined timeout interval was elapsed
@@ -160,6 +179,23 @@ class StopTimer {
     }
   }
 
+  /**
+   * @brief start time point
+   * @return time point of the last start
+   */
+  [[nodiscard]] TimePoint StartPoint() const noexcept {
+    return m_start_point;
+  }
+
+  /**
+   * @brief deadline time point
+   * @details start point plus timeout, meaningful only while the timer is running
+   * @return time point at which the timeout elapses
+   */
+  [[nodiscard]] TimePoint Deadline() const noexcept {
+    return m_start_point + m_timeout_duration;
+  }
+
   /**
    * @brief current time for used clock from chrono
    * @details static function used many times in class
@@ -0,0 +1,64 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for serialized execution on the worker pool.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "workerPool.hpp"
+
+namespace tev {
+
+/**
+ * @brief Runs tasks on a worker pool with strands: tasks posted with the same key never run
+ * concurrently and keep their posting order, tasks with different keys run in parallel.
+ *
+ * A strand exists only while it has queued or running tasks. It is drained by one pool task at a time,
+ * which hands the strand back to the pool after kDrainBatch tasks so a busy strand cannot occupy a
+ * worker forever. Destruction waits until all strands are drained.
+ */
+class StrandExecutor {
+ public:
+  using Task = WorkerPool::Task;
+  static constexpr std::size_t kDrainBatch{16};
+
+  explicit StrandExecutor(WorkerPool& pool) : m_Pool(pool) {}
+  virtual ~StrandExecutor();
+  StrandExecutor(const StrandExecutor&) = delete;
+  StrandExecutor& operator=(const StrandExecutor&) = delete;
+
+  /**
+   * @brief queue a task on a strand
+   * @param key - strand key, nullptr runs the task without serialization
+   * @param task - task to execute
+   */
+  void post(const void* key, Task task);
+
+  /**
+   * @brief number of strands with queued or running tasks
+   */
+  [[nodiscard]] std::size_t getActiveStrands();
+
+ private:
+  void drain(const void* key);
+
+  WorkerPool& m_Pool;                                           ///< Pool executing the strands
+  std::mutex m_Mutex;                                           ///< Guards the strand queues
+  std::condition_variable m_Drained;                            ///< Signals that the last strand was drained
+  std::unordered_map<const void*, std::deque<Task>> m_Strands;  ///< Pending tasks of the active strands
+};
+
+}  // end of namespace tev
@@ -0,0 +1,64 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the timer file descriptor.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <chrono>
+
+namespace tev {
+
+/**
+ * @brief Owns a Linux timerfd on CLOCK_MONOTONIC.
+ *
+ * The descriptor becomes readable when the armed point in time is reached, so it can be watched by
+ * epoll, poll or an asio descriptor next to the other descriptors of an event loop. It is
+ * non-blocking, reading it with drain() never waits. On other systems no descriptor is created and
+ * getFd() returns -1.
+ */
+class TimerFd {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  /**
+   * @throws std::system_error if the descriptor cannot be created
+   */
+  TimerFd();
+  virtual ~TimerFd();
+  TimerFd(const TimerFd&) = delete;
+  TimerFd& operator=(const TimerFd&) = delete;
+
+  /**
+   * @brief makes the descriptor readable at deadline, immediately if it passed already
+   */
+  void arm(TimePoint deadline) noexcept;
+
+  /**
+   * @brief makes the descriptor readable right away
+   */
+  void armNow() noexcept;
+
+  /**
+   * @brief cancels the armed point in time, the descriptor stays readable until drain()
+   */
+  void disarm() noexcept;
+
+  /**
+   * @brief consumes the expirations, the descriptor is not readable afterwards
+   */
+  void drain() noexcept;
+
+  [[nodiscard]] int getFd() const noexcept {
+    return m_Fd;
+  }
+
+ private:
+  int m_Fd{-1};  ///< timerfd descriptor
+};
+
+}  // end of namespace tev
@@ -0,0 +1,291 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains hierarchical timing wheel for coarse-grained timeouts.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "event.hpp"
+#include "iEventQueue.hpp"
+
+namespace tev {
+
+/**
+ * @brief Hashed hierarchical timing wheel of scheduled events.
+ *
+ * Four levels of 256 buckets each cover 2^32 ticks. Insert and cancel are O(1), expiry is amortized
+ * O(1): an event is moved down at most once per level before it fires. Deadlines are rounded up to the
+ * tick resolution, so events never fire early but may fire up to one tick late, and events within the
+ * same tick are not ordered. Deadlines beyond the wheel range are parked in the last bucket of the top
+ * level and re-hashed when it cascades.
+ */
+class TimingWheel : public IEventQueue {
+ public:
+  using Duration = std::chrono::steady_clock::duration;
+  static constexpr DurationUnit kDefaultResolution{1ms};
+  static constexpr std::size_t kLevels{4};
+  static constexpr std::size_t kSlotBits{8};
+  static constexpr std::size_t kSlots{std::size_t{1} << kSlotBits};
+  static constexpr std::uint64_t kSlotMask{kSlots - 1};
+  static constexpr std::uint64_t kRangeTicks{std::uint64_t{1} << (kSlotBits * kLevels)};
+
+  /**
+   * @brief constructor
+   * @param resolution - duration of one tick
+   * @param origin - point in time of tick zero
+   */
+  explicit TimingWheel(DurationUnit resolution = kDefaultResolution,
+                       TimePoint origin = std::chrono::steady_clock::now())
+      : m_Resolution(std::max<Duration>(resolution, Duration{1})), m_Origin(origin), m_Slots(kLevels * kSlots) {}
+
+  [[nodiscard]] std::size_t size() const noexcept override {
+    return m_Size;
+  }
+  [[nodiscard]] Duration resolution() const noexcept {
+    return m_Resolution;
+  }
+
+  [[nodiscard]] bool contains(const Event& event) const noexcept override {
+    const auto slot = event.getQueueSlot();
+    const auto index = event.getQueueIndex();
+    return slot < m_Slots.size() && index < m_Slots[slot].size() && m_Slots[slot][index].event.get() == &event;
+  }
+
+  void push(EventPtr event, TimePoint deadline) override {
+    insert(Entry{deadline, std::move(event)});
+    ++m_Size;
+  }
+
+  bool update(const Event& event, TimePoint deadline) override {
+    auto removed = erase(event);
+    if (!removed) {
+      return false;
+    }
+    push(std::move(removed), deadline);
+    return true;
+  }
+
+  EventPtr erase(const Event& event) override {
+    if (!contains(event)) {
+      return nullptr;
+    }
+    --m_Size;
+    return removeAt(event.getQueueSlot(), event.getQueueIndex());
+  }
+
+  std::size_t eraseIf(const EventPredicate& pred) override {
+    std::size_t removed = 0;
+    for (std::size_t slot = 0; slot < m_Slots.size(); ++slot) {
+      for (std::size_t index = 0; index < m_Slots[slot].size();) {
+        if (pred(m_Slots[slot][index].event)) {
+          removeAt(slot, index);
+          ++removed;
+        } else {
+          ++index;
+        }
+      }
+    }
+    m_Size -= removed;
+    return removed;
+  }
+
+  /**
+   * @brief earliest point in time at which the wheel may have due events
+   * @details exact to the tick for the lowest level, for higher levels the time of the next cascade
+   * @return point in time or std::nullopt if the wheel is empty
+   */
+  [[nodiscard]] std::optional<TimePoint> earliestDeadline() const override {
+    if (m_Size == 0) {
+      return std::nullopt;
+    }
+    auto best = std::numeric_limits<std::uint64_t>::max();
+    const auto first = nextOccupied(0, m_Current & kSlotMask);
+    if (first < kSlots) {
+      best = m_Current + first;
+    }
+    for (std::size_t level = 1; level < kLevels; ++level) {
+      const auto shift = kSlotBits * level;
+      // the bucket of the current round is still pending if the cascade at its start has not run yet
+      const bool pending = (m_Current & ((std::uint64_t{1} << shift) - 1)) == 0;
+      const auto from = (m_Current >> shift) + (pending ? 0 : 1);
+      const auto distance = nextOccupied(level, from & kSlotMask);
+      if (distance < kSlots) {
+        best = std::min(best, (from + distance) << shift);
+      }
+    }
+    return m_Origin + m_Resolution * static_cast<Duration::rep>(best);
+  }
+
+  void popDue(TimePoint now, std::vector<EventPtr>& due) override {
+    if (now < m_Origin) {
+      return;
+    }
+    const auto target = static_cast<std::uint64_t>((now - m_Origin) / m_Resolution);
+    while (m_Current <= target) {
+      if (m_Size == 0) {
+        m_Current = target + 1;
+        break;
+      }
+      if ((m_Current & kSlotMask) == 0) {
+        cascade();
+      }
+      auto& slot = m_Slots[m_Current & kSlotMask];
+      for (auto& entry : slot) {
+        entry.event->setQueueSlot(Event::kNotQueued);
+        entry.event->setQueueIndex(Event::kNotQueued);
+        due.push_back(std::move(entry.event));
+      }
+      m_Size -= slot.size();
+      slot.clear();
+      clearBit(0, m_Current & kSlotMask);
+      // skip empty ticks up to the next occupied bucket or the end of this round
+      const auto position = (m_Current & kSlotMask) + 1;
+      const auto distance = position < kSlots ? nextOccupied(0, position) : kSlots;
+      const auto roundEnd = (m_Current | kSlotMask) + 1;
+      const auto next = distance < kSlots && position + distance < kSlots ? m_Current + 1 + distance : roundEnd;
+      m_Current = std::min(next, target + 1);
+    }
+  }
+
+  void clear() override {
+    for (auto& slot : m_Slots) {
+      for (auto& entry : slot) {
+        entry.event->setQueueSlot(Event::kNotQueued);
+        entry.event->setQueueIndex(Event::kNotQueued);
+      }
+      slot.clear();
+    }
+    m_Bitmap = {};
+    m_Size = 0;
+  }
+
+  void reserve(std::size_t /*count*/) override {
+    // the slot vectors grow to their working size and keep their capacity
+  }
+
+ private:
+  using Bitmap = std::array<std::uint64_t, kSlots / 64>;
+
+  struct Entry {
+    TimePoint deadline;  ///< Exact deadline, kept for re-hashing on cascade
+    EventPtr event;      ///< Scheduled event
+  };
+
+  [[nodiscard]] std::uint64_t tickOf(TimePoint deadline) const {
+    if (deadline <= m_Origin) {
+      return 0;
+    }
+    const auto ticks = (deadline - m_Origin + m_Resolution - Duration{1}) / m_Resolution;
+    return static_cast<std::uint64_t>(ticks);
+  }
+
+  void insert(Entry&& entry) {
+    auto tick = std::max(tickOf(entry.deadline), m_Current);
+    auto delta = tick - m_Current;
+    if (delta >= kRangeTicks) {
+      delta = kRangeTicks - 1;
+      tick = m_Current + delta;
+    }
+    std::size_t level = 0;
+    while (level + 1 < kLevels && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) {
+      ++level;
+    }
+    const auto index = (tick >> (kSlotBits * level)) & kSlotMask;
+    const auto slot = level * kSlots + index;
+    entry.event->setQueueSlot(slot);
+    entry.event->setQueueIndex(m_Slots[slot].size());
+    m_Slots[slot].push_back(std::move(entry));
+    setBit(level, index);
+  }
+
+  EventPtr removeAt(std::size_t slot, std::size_t index) {
+    auto& bucket = m_Slots[slot];
+    auto removed = std::move(bucket[index].event);
+    removed->setQueueSlot(Event::kNotQueued);
+    removed->setQueueIndex(Event::kNotQueued);
+    if (index + 1 != bucket.size()) {
+      bucket[index] = std::move(bucket.back());
+      bucket[index].event->setQueueIndex(index);
+    }
+    bucket.pop_back();
+    if (bucket.empty()) {
+      clearBit(slot / kSlots, slot % kSlots);
+    }
+    return removed;
+  }
+
+  /// Moves the buckets of the higher levels whose round starts at the current tick one level down.
+  void cascade() {
+    for (auto level = kLevels - 1; level > 0; --level) {
+      const auto shift = kSlotBits * level;
+      if ((m_Current & ((std::uint64_t{1} << shift) - 1)) != 0) {
+        continue;
+      }
+      const auto index = (m_Current >> shift) & kSlotMask;
+      auto entries = std::move(m_Slots[level * kSlots + index]);
+      m_Slots[level * kSlots + index].clear();
+      clearBit(level, index);
+      for (auto& entry : entries) {
+        insert(std::move(entry));
+      }
+    }
+  }
+
+  void setBit(std::size_t level, std::uint64_t index) {
+    m_Bitmap[level][index / 64] |= std::uint64_t{1} << (index % 64);
+  }
+  void clearBit(std::size_t level, std::uint64_t index) {
+    m_Bitmap[level][index / 64] &= ~(std::uint64_t{1} << (index % 64));
+  }
+
+  /**
+   * @brief circular distance from a bucket to the next occupied bucket of a level
+   * @param level - wheel level
+   * @param from - first bucket to look at
+   * @return distance in buckets or kSlots if the level is empty
+   */
+  [[nodiscard]] std::uint64_t nextOccupied(std::size_t level, std::uint64_t from) const {
+    const auto& bitmap = m_Bitmap[level];
+    for (std::uint64_t step = 0; step <= bitmap.size(); ++step) {
+      const auto word = (from / 64 + step) % bitmap.size();
+      auto bits = bitmap[word];
+      if (step == 0) {
+        bits &= ~std::uint64_t{0} << (from % 64);
+      } else if (step == bitmap.size()) {
+        bits &= (std::uint64_t{1} << (from % 64)) - 1;
+      }
+      if (bits != 0) {
+        const auto index = word * 64 + static_cast<std::uint64_t>(std::countr_zero(bits));
+        return (index + kSlots - from) % kSlots;
+      }
+    }
+    return kSlots;
+  }
+
+  Duration m_Resolution;                    ///< Duration of one tick
+  TimePoint m_Origin;                       ///< Point in time of tick zero
+  std::uint64_t m_Current{0};               ///< Next tick to be expired
+  std::size_t m_Size{0};                    ///< Number of queued events
+  std::vector<std::vector<Entry>> m_Slots;  ///< Buckets of all levels, level-major
+  std::array<Bitmap, kLevels> m_Bitmap{};   ///< Occupied buckets per level
+};
+
+}  // end of namespace tev
@@ -0,0 +1,88 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for event configurations with typed callbacks.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "event.hpp"
+#include "iController.hpp"
+#include "iUserData.hpp"
+
+namespace tev {
+
+/**
+ * @brief Event configuration whose callbacks receive controller and user data with their concrete types.
+ *
+ * A callback is invoked as callback(event, controller, userData) with TController& and TUserData&.
+ * Each callback is wrapped into a ControllerEventCallback which only captures the callback itself
+ * and turns the type-erased pointers of the event into references with static_cast, so neither RTTI
+ * nor a reference count is touched when it fires. nullptr leaves a callback empty. The events are
+ * ordinary events and share the scheduler with events of the type-erased EventConfig.
+ *
+ * Use with Scheduler::pushEvent(controller, userData, typedConfig), whose signature makes sure the
+ * event gets a controller and user data of exactly these types.
+ *
+ * @tparam TController - controller type, derived from IController
+ * @tparam TUserData - user data type, derived from IUserData
+ */
+template <class TController, class TUserData>
+class TypedEventConfig {
+ public:
+  static_assert(std::is_base_of_v<IController, TController>, "TController must derive from IController");
+  static_assert(std::is_base_of_v<IUserData, TUserData>, "TUserData must derive from IUserData");
+
+  template <class FStart, class FEvent, class FAbort, class FComplete, class FTimeout>
+  TypedEventConfig(DurationUnit delayMs, DurationUnit serveMs, DurationUnit lifeMs, FStart startCallback,
+                   FEvent eventCallback, FAbort abortCallback, FComplete completeCallback, FTimeout timeoutCallback,
+                   CatchUpPolicy catchUpPolicy = CatchUpPolicy::Skip)
+      : m_Config(delayMs, serveMs, lifeMs, adapt(std::move(startCallback)), adapt(std::move(eventCallback)),
+                 adapt(std::move(abortCallback)), adapt(std::move(completeCallback)),
+                 adapt(std::move(timeoutCallback)), catchUpPolicy) {}
+
+  /**
+   * @brief the type-erased configuration with the wrapped callbacks
+   */
+  [[nodiscard]] const EventConfig& getConfig() const noexcept {
+    return m_Config;
+  }
+  /**
+   * @brief the type-erased configuration, e.g. to set the slack or the catch-up policy
+   */
+  [[nodiscard]] EventConfig& getConfig() noexcept {
+    return m_Config;
+  }
+
+  /**
+   * @brief wraps a typed callback into a ControllerEventCallback
+   */
+  template <class F>
+  [[nodiscard]] static ControllerEventCallback adapt(F callback) {
+    if constexpr (std::is_null_pointer_v<F>) {
+      return nullptr;
+    } else {
+      static_assert(std::is_invocable_v<F&, const EventPtr&, TController&, TUserData&>,
+                    "callback must be invocable as callback(const EventPtr&, TController&, TUserData&)");
+      return [callback = std::move(callback)](const EventPtr& event) mutable {
+        callback(event, static_cast<TController&>(*event->getController()),
+                 static_cast<TUserData&>(*event->getUserData()));
+      };
+    }
+  }
+
+ private:
+  EventConfig m_Config;  ///< Configuration with the wrapped callbacks
+};
+
+}  // end of namespace tev
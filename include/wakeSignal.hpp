@@ -0,0 +1,74 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the futex based wake-up signal.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace tev {
+
+/**
+ * @brief Wake-up signal of one waiting thread without lost notifications.
+ *
+ * The waiter takes a token with prepare() before it looks for work and passes it to waitUntil(),
+ * which returns at once if notify() was called after prepare(). The token is a sequence number in a
+ * single atomic word which the waiter blocks on with a futex, so there is no separate mutex whose
+ * ordering against the wait could be missed. notify() costs one atomic increment and only enters
+ * the kernel while a thread is blocked. Systems without futex use a condition variable instead.
+ */
+class WakeSignal {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+  using Token = std::uint32_t;
+
+  WakeSignal() = default;
+  virtual ~WakeSignal() = default;
+  WakeSignal(const WakeSignal&) = delete;
+  WakeSignal& operator=(const WakeSignal&) = delete;
+
+  /**
+   * @brief token of the notifications seen so far, taken before checking for work
+   */
+  [[nodiscard]] Token prepare() const noexcept {
+    return m_Sequence.load(std::memory_order_seq_cst);
+  }
+
+  /**
+   * @brief whether notify() was called since the token was taken
+   */
+  [[nodiscard]] bool notified(Token token) const noexcept {
+    return m_Sequence.load(std::memory_order_acquire) != token;
+  }
+
+  /**
+   * @brief blocks until notify() after the token was taken or until the deadline
+   * @param deadline - absolute deadline, TimePoint::max() to wait without limit
+   * @return true if notified
+   */
+  bool waitUntil(Token token, TimePoint deadline);
+
+  /**
+   * @brief ends the current or the next wait, callable from any thread
+   */
+  void notify() noexcept;
+
+ private:
+  std::atomic<Token> m_Sequence{0};         ///< Incremented by every notify(), the futex word
+  std::atomic<std::uint32_t> m_Waiters{0};  ///< Threads blocked in waitUntil()
+#if !defined(__linux__)
+  std::mutex m_Mutex;                 ///< Guards the condition variable
+  std::condition_variable m_CondVar;  ///< Replaces the futex
+#endif
+};
+
+}  // end of namespace tev
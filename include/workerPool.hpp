@@ -0,0 +1,82 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class declarations for the callback worker pool.
+ * \ingroup Scheduled Events
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// includes "..."
+//-----------------------------------------------------------------------------
+#include "inplaceFunction.hpp"
+
+namespace tev {
+
+/**
+ * @brief Pool of worker threads with per-worker deques and work stealing.
+ *
+ * Tasks submitted from outside the pool are distributed round-robin over the workers. A task submitted
+ * from a worker thread goes to the deque of that worker. Every worker takes tasks from the front of its
+ * own deque and, when it runs dry, steals from the back of the other deques. Idle workers sleep until
+ * new tasks arrive. Queued tasks are still executed when the pool is destroyed.
+ * Tasks are stored inline with captures of up to kTaskBufferSize bytes, submitting does not
+ * allocate once the deques reached their working size.
+ */
+class WorkerPool {
+ public:
+  static constexpr std::size_t kTaskBufferSize{48};
+  using Task = InplaceFunction<void(), kTaskBufferSize>;
+
+  explicit WorkerPool(std::size_t threadCount);
+  virtual ~WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief queue a task for execution on one of the workers
+   * @param task - task to execute
+   */
+  void submit(Task task);
+
+  [[nodiscard]] std::size_t getThreadCount() const {
+    return m_Workers.size();
+  }
+
+  /**
+   * @brief checks whether the calling thread is a worker of this pool
+   */
+  [[nodiscard]] bool isWorkerThread() const;
+
+ private:
+  /// Task deque of one worker
+  struct Worker {
+    std::mutex mutex;        ///< Guards the deque
+    std::deque<Task> tasks;  ///< Own tasks at the front, stolen from the back
+    std::jthread thread;     ///< Worker thread
+  };
+
+  void run(std::size_t self);
+  bool tryPop(std::size_t self, Task& task);
+
+  std::vector<std::unique_ptr<Worker>> m_Workers;  ///< Workers with their deques
+  std::atomic<std::size_t> m_Pending{0};           ///< Number of queued tasks over all deques
+  std::atomic<std::size_t> m_NextWorker{0};        ///< Round-robin index for external submissions
+  std::mutex m_IdleMutex;                          ///< Guards sleeping of idle workers
+  std::condition_variable m_IdleEvent;             ///< Wakes idle workers on new tasks or stop
+  bool m_Stop{false};                              ///< Stop request, guarded by m_IdleMutex
+};
+
+}  // end of namespace tev
@@ -0,0 +1,137 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations for the clocks a scheduler reads its time from.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#if (defined(__x86_64__) || defined(__i386__)) && __has_include(<cpuid.h>)
+#define TEV_HAS_CPUID 1
+#include <cpuid.h>
+#endif
+
+#include "clock.hpp"
+
+namespace tev {
+
+namespace {
+
+/// Extended cpuid leaf with the power management features
+constexpr unsigned kPowerLeaf{0x80000007U};
+/// Bit of the invariant counter, its rate neither changes with the frequency nor stops in sleep states
+constexpr unsigned kInvariantTscBit{1U << 8U};
+
+bool hasInvariantTsc() {
+#if defined(TEV_HAS_CPUID)
+  unsigned eax = 0;
+  unsigned ebx = 0;
+  unsigned ecx = 0;
+  unsigned edx = 0;
+  if (__get_cpuid_max(0x80000000U, nullptr) < kPowerLeaf || __get_cpuid(kPowerLeaf, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  return (edx & kInvariantTscBit) != 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace
+
+std::chrono::nanoseconds CoarseClock::resolution() noexcept {
+#if defined(CLOCK_MONOTONIC_COARSE)
+  timespec step{};
+  if (clock_getres(CLOCK_MONOTONIC_COARSE, &step) == 0) {
+    return std::chrono::seconds(step.tv_sec) + std::chrono::nanoseconds(step.tv_nsec);
+  }
+#endif
+  return std::chrono::nanoseconds{0};
+}
+
+std::shared_ptr<TscClock> TscClock::create(std::chrono::nanoseconds calibration) {
+  if (!hasInvariantTsc()) {
+    return nullptr;
+  }
+  const auto first = sample();
+  std::this_thread::sleep_for(calibration);
+  const auto origin = sample();
+  if (origin.ticks <= first.ticks || origin.time <= first.time) {
+    return nullptr;
+  }
+  return std::make_shared<TscClock>(first, origin);
+}
+
+TscClock::TscClock(Sample first, Sample origin) : m_First(first) {
+  setOrigin(origin, origin.time);
+  const auto ticksPerSecond = std::ldexp(1e9L, kScaleShift) / static_cast<long double>(m_Scale.load());
+  m_ReanchorTicks = static_cast<std::int64_t>(ticksPerSecond * kReanchorPeriod.count());
+}
+
+/**
+ * @brief Reads steady_clock between two counter reads.
+ * @details The counter is taken as the middle of both, the reading with the shortest gap out of a
+ * few is kept since an interrupt in between makes the pair inexact.
+ */
+TscClock::Sample TscClock::sample() noexcept {
+  constexpr int kAttempts{5};
+  Sample best{0, 0};
+  auto bestGap = ~std::uint64_t{0};
+  for (int attempt = 0; attempt < kAttempts; ++attempt) {
+    const auto before = readTicks();
+    const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+    const auto after = readTicks();
+    if (after - before < bestGap) {
+      bestGap = after - before;
+      best = Sample{before + bestGap / 2, time};
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Restarts the extrapolation from a new reading of steady_clock.
+ * @details Only the thread which turns the sequence odd writes, the others retry their read. Reads
+ * on the old origin took their counter before the sequence turned odd and at most kReanchorPeriod
+ * past the old origin. If steady_clock lies behind the old extrapolation of that point, the new
+ * origin starts there instead, so the time never steps back.
+ */
+void TscClock::reanchor(std::uint64_t sequence) const noexcept {
+  auto expected = sequence;
+  if (!m_Sequence.compare_exchange_strong(expected, sequence + 1, std::memory_order_acquire)) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  const auto origin = sample();
+  const auto oldTicks = m_OriginTicks.load(std::memory_order_relaxed);
+  const auto elapsed = std::min(static_cast<std::int64_t>(origin.ticks - oldTicks), m_ReanchorTicks);
+  const auto latest = m_OriginTime.load(std::memory_order_relaxed) +
+                      ((elapsed * static_cast<std::int64_t>(m_Scale.load(std::memory_order_relaxed))) >> kScaleShift);
+  setOrigin(origin, std::max(origin.time, latest));
+  m_Sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Sets the origin and measures the rate from the first reading to it.
+ * @details An origin ahead of the reading runs slower until the next re-anchor so that it meets
+ * steady_clock again, otherwise the lead of every re-anchor would add up.
+ * @param origin - reading of steady_clock the rate is measured to
+ * @param time - nanoseconds of the origin, the time of the reading or later
+ */
+void TscClock::setOrigin(Sample origin, std::int64_t time) const noexcept {
+  const auto ticks = static_cast<long double>(origin.ticks - m_First.ticks);
+  const auto nanos = static_cast<long double>(origin.time - m_First.time);
+  const auto lead = static_cast<long double>(time - origin.time) /
+                    std::chrono::duration<long double, std::nano>(kReanchorPeriod).count();
+  const auto rate = nanos / ticks * std::max(0.5L, 1.0L - lead);
+  m_Scale.store(static_cast<std::uint64_t>(std::ldexp(rate, kScaleShift)), std::memory_order_relaxed);
+  m_OriginTicks.store(origin.ticks, std::memory_order_relaxed);
+  m_OriginTime.store(time, std::memory_order_relaxed);
+}
+
+}  // end of namespace tev
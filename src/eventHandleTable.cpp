@@ -0,0 +1,137 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of the table behind event handles.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <stdexcept>
+
+#include "eventHandleTable.hpp"
+
+namespace tev {
+
+EventHandleTable::EventHandleTable(std::uint32_t tag) : m_Tag(tag) {
+  if (tag > kMaxTag) {
+    throw std::invalid_argument("EventHandleTable: tag out of range");
+  }
+}
+
+EventHandleTable::~EventHandleTable() {
+  for (auto& chunk : m_Chunks) {
+    delete[] chunk.load(std::memory_order_relaxed);
+  }
+}
+
+EventHandle EventHandleTable::acquire(Event* event) {
+  auto head = m_FreeHead.load(std::memory_order_acquire);
+  while (slotOf(head) != EventHandle::kInvalidSlot) {
+    // slots are never freed, reading a slot popped concurrently is harmless, the tag fails the exchange
+    Slot& slot = *find(slotOf(head));
+    const auto next = slot.nextFree.load(std::memory_order_relaxed);
+    if (m_FreeHead.compare_exchange_weak(head, pack(next, tagOf(head) + 1), std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+      return bind(slotOf(head), slot, event);
+    }
+  }
+  const auto index = m_Next.fetch_add(1, std::memory_order_acq_rel);
+  if (index >= kMaxChunks * kChunkSize) {
+    m_Next.fetch_sub(1, std::memory_order_acq_rel);
+    throw std::length_error("EventHandleTable: no free slot");
+  }
+  return bind(index, ensure(index), event);
+}
+
+bool EventHandleTable::release(const EventHandle& handle) {
+  Slot* slot = find(handle);
+  if (slot == nullptr) {
+    return false;
+  }
+  auto generation = handle.generation;
+  if (!slot->generation.compare_exchange_strong(generation, generation + 1, std::memory_order_acq_rel)) {
+    return false;
+  }
+  slot->event.store(nullptr, std::memory_order_relaxed);
+  auto head = m_FreeHead.load(std::memory_order_relaxed);
+  do {
+    slot->nextFree.store(slotOf(head), std::memory_order_relaxed);
+  } while (!m_FreeHead.compare_exchange_weak(head, pack(handle.slot & kIndexMask, tagOf(head) + 1),
+                                             std::memory_order_release, std::memory_order_relaxed));
+  return true;
+}
+
+bool EventHandleTable::isLive(const EventHandle& handle) const {
+  const Slot* slot = find(handle);
+  return slot != nullptr && slot->generation.load(std::memory_order_acquire) == handle.generation;
+}
+
+std::optional<Event::Status> EventHandleTable::getStatus(const EventHandle& handle) const {
+  const Slot* slot = find(handle);
+  if (slot == nullptr || slot->generation.load(std::memory_order_acquire) != handle.generation) {
+    return std::nullopt;
+  }
+  const auto status = slot->status.load(std::memory_order_acquire);
+  // the slot may have been released while the status was read
+  if (slot->generation.load(std::memory_order_acquire) != handle.generation) {
+    return std::nullopt;
+  }
+  return status;
+}
+
+void EventHandleTable::setStatus(const EventHandle& handle, Event::Status status) {
+  Slot* slot = find(handle);
+  if (slot != nullptr && slot->generation.load(std::memory_order_relaxed) == handle.generation) {
+    slot->status.store(status, std::memory_order_release);
+  }
+}
+
+Event* EventHandleTable::get(const EventHandle& handle) const {
+  const Slot* slot = find(handle);
+  if (slot == nullptr || slot->generation.load(std::memory_order_acquire) != handle.generation) {
+    return nullptr;
+  }
+  return slot->event.load(std::memory_order_acquire);
+}
+
+EventHandleTable::Slot* EventHandleTable::find(std::uint32_t index) const {
+  if (index >= kMaxChunks * kChunkSize) {
+    return nullptr;
+  }
+  Slot* chunk = m_Chunks[index >> kChunkBits].load(std::memory_order_acquire);
+  return chunk != nullptr ? &chunk[index & (kChunkSize - 1)] : nullptr;
+}
+
+/**
+ * @brief Slot of a handle, nullptr for handles of other tables and invalid handles.
+ */
+EventHandleTable::Slot* EventHandleTable::find(const EventHandle& handle) const {
+  if (!handle.valid() || tagOfHandle(handle) != m_Tag) {
+    return nullptr;
+  }
+  return find(handle.slot & kIndexMask);
+}
+
+EventHandleTable::Slot& EventHandleTable::ensure(std::uint32_t index) {
+  auto& chunk = m_Chunks[index >> kChunkBits];
+  Slot* slots = chunk.load(std::memory_order_acquire);
+  if (slots == nullptr) {
+    // several producers may reach a new chunk at once, the first one installs it
+    auto* fresh = new Slot[kChunkSize];
+    if (chunk.compare_exchange_strong(slots, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      slots = fresh;
+    } else {
+      delete[] fresh;
+    }
+  }
+  return slots[index & (kChunkSize - 1)];
+}
+
+EventHandle EventHandleTable::bind(std::uint32_t index, Slot& slot, Event* event) {
+  slot.event.store(event, std::memory_order_relaxed);
+  slot.status.store(Event::Status::Pending, std::memory_order_relaxed);
+  // other threads see the slot through the handle, which is passed on with the usual synchronization
+  return EventHandle{(m_Tag << kIndexBits) | index, slot.generation.load(std::memory_order_relaxed)};
+}
+
+}  // end of namespace tev
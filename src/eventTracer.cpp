@@ -0,0 +1,226 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations for tracing event lifecycles into per-thread ring buffers.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <string_view>
+
+#include "eventTracer.hpp"
+
+namespace tev {
+
+namespace {
+
+/// Source of the tracer ids, 0 is never used so that an empty per-thread cache matches no tracer
+std::atomic<std::uint64_t> nextTracerId{1};
+
+std::string_view statusName(Event::Status status) {
+  switch (status) {
+    case Event::Status::Pending:
+      return "Pending";
+    case Event::Status::Running:
+      return "Running";
+    case Event::Status::Completed:
+      return "Completed";
+    case Event::Status::Aborted:
+      return "Aborted";
+    case Event::Status::Timeouted:
+      return "Timeouted";
+  }
+  return "Unknown";
+}
+
+std::string_view callbackName(EventTracer::Callback callback) {
+  switch (callback) {
+    case EventTracer::Callback::Start:
+      return "start";
+    case EventTracer::Callback::Serve:
+      return "serve";
+    case EventTracer::Callback::Complete:
+      return "complete";
+    case EventTracer::Callback::Abort:
+      return "abort";
+    case EventTracer::Callback::Timeout:
+      return "timeout";
+  }
+  return "unknown";
+}
+
+void writeEscaped(std::ostream& out, std::string_view text) {
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+}
+
+}  // namespace
+
+EventTracer::EventTracer(std::size_t capacity, std::shared_ptr<IClock> clock)
+    : m_Mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+      m_Clock(clock ? std::move(clock) : SteadyClock::instance()),
+      m_Id(nextTracerId.fetch_add(1, std::memory_order_relaxed)) {}
+
+void EventTracer::nameThread(std::string name) {
+  auto& ring = ringOfThread();
+  const std::lock_guard lg(m_Mutex);
+  ring.name = std::move(name);
+}
+
+/**
+ * @brief Creates the ring of the calling thread or finds the one it had.
+ * @details A thread recording alternately into two tracers misses the per-thread cache and gets
+ * its ring back from here.
+ */
+EventTracer::Ring& EventTracer::registerThread() {
+  const auto self = std::this_thread::get_id();
+  const std::lock_guard lg(m_Mutex);
+  const auto found = std::find_if(m_Rings.begin(), m_Rings.end(), [&](const auto& ring) {
+    return ring->thread == self;
+  });
+  if (found != m_Rings.end()) {
+    return **found;
+  }
+  auto ring = std::make_unique<Ring>(m_Mask + 1);
+  ring->thread = self;
+  ring->name = "thread " + std::to_string(m_Rings.size());
+  m_Rings.push_back(std::move(ring));
+  return *m_Rings.back();
+}
+
+/**
+ * @brief Copies the rings like a seqlock.
+ * @details The writer raises claimed before a slot changes and committed after. Records up to the
+ * committed count are copied, then the claimed count tells which of them were overwritten meanwhile.
+ */
+std::vector<EventTracer::ThreadTrace> EventTracer::snapshot() const {
+  const auto capacity = static_cast<std::uint64_t>(m_Mask + 1);
+  const std::lock_guard lg(m_Mutex);
+  std::vector<ThreadTrace> traces;
+  traces.reserve(m_Rings.size());
+  for (const auto& ring : m_Rings) {
+    const auto committed = ring->committed.load(std::memory_order_acquire);
+    auto first = committed > capacity ? committed - capacity : 0;
+    std::vector<Record> records;
+    records.reserve(committed - first);
+    for (auto index = first; index < committed; ++index) {
+      const auto& slot = ring->slots[index & m_Mask];
+      const auto event = slot.event.load(std::memory_order_relaxed);
+      const auto meta = slot.meta.load(std::memory_order_relaxed);
+      const auto detail = static_cast<std::uint8_t>(meta & 0xFFU);
+      Record record;
+      record.time = TimePoint{TimePoint::duration{slot.time.load(std::memory_order_relaxed)}};
+      record.kind = static_cast<Kind>(meta >> 8U);
+      record.event = EventHandle{static_cast<std::uint32_t>(event >> 32U), static_cast<std::uint32_t>(event)};
+      record.from = static_cast<Event::Status>(detail >> 4U);
+      record.to = static_cast<Event::Status>(detail & 0x0FU);
+      record.callback = static_cast<Callback>(detail);
+      record.notified = detail != 0;
+      records.push_back(record);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto claimed = ring->claimed.load(std::memory_order_relaxed);
+    const auto overwritten = claimed > capacity ? claimed - capacity : 0;
+    if (overwritten > first) {
+      const auto torn = std::min(overwritten, committed) - first;
+      records.erase(records.begin(), records.begin() + static_cast<std::ptrdiff_t>(torn));
+      first += torn;
+    }
+    traces.push_back(ThreadTrace{ring->name, std::move(records), first});
+  }
+  return traces;
+}
+
+void EventTracer::writeChromeTrace(std::ostream& out) const {
+  const auto traces = snapshot();
+  auto origin = TimePoint::max();
+  for (const auto& trace : traces) {
+    if (!trace.records.empty()) {
+      origin = std::min(origin, trace.records.front().time);
+    }
+  }
+  const auto micros = [&](TimePoint time) {
+    return std::chrono::duration<double, std::micro>(time - origin).count();
+  };
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  const auto begin = [&](std::string_view name, std::string_view category, char phase, std::size_t tid) {
+    out << (first ? "\n" : ",\n") << "{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"" << phase
+        << "\",\"pid\":1,\"tid\":" << tid;
+    first = false;
+  };
+  const auto eventArgs = [&](const EventHandle& event) {
+    out << ",\"args\":{\"event\":\"" << event.slot << ':' << event.generation << "\"}";
+  };
+
+  for (std::size_t tid = 0; tid < traces.size(); ++tid) {
+    const auto& trace = traces[tid];
+    begin("thread_name", "__metadata", 'M', tid);
+    out << ",\"args\":{\"name\":\"";
+    writeEscaped(out, trace.name);
+    out << "\"}}";
+
+    // slices need their begin, the oldest records may have lost it to the ring
+    bool inCallback = false;
+    bool sleeping = false;
+    for (const auto& record : trace.records) {
+      switch (record.kind) {
+        case Kind::Status: {
+          const auto name = std::string(statusName(record.from)) + "->" + std::string(statusName(record.to));
+          begin(name, "status", 'i', tid);
+          out << ",\"s\":\"t\",\"ts\":" << micros(record.time);
+          eventArgs(record.event);
+          out << '}';
+          break;
+        }
+        case Kind::CallbackBegin:
+          begin(callbackName(record.callback), "callback", 'B', tid);
+          out << ",\"ts\":" << micros(record.time);
+          eventArgs(record.event);
+          out << '}';
+          inCallback = true;
+          break;
+        case Kind::CallbackEnd:
+          if (inCallback) {
+            begin(callbackName(record.callback), "callback", 'E', tid);
+            out << ",\"ts\":" << micros(record.time) << '}';
+            inCallback = false;
+          }
+          break;
+        case Kind::Sleep:
+          begin("sleep", "scheduler", 'B', tid);
+          out << ",\"ts\":" << micros(record.time) << '}';
+          sleeping = true;
+          break;
+        case Kind::Wake:
+          if (sleeping) {
+            begin("sleep", "scheduler", 'E', tid);
+            out << ",\"ts\":" << micros(record.time) << ",\"args\":{\"woken\":\""
+                << (record.notified ? "notified" : "deadline") << "\"}}";
+            sleeping = false;
+          }
+          break;
+      }
+    }
+  }
+  out << "\n]}\n";
+}
+
+bool EventTracer::writeFile(const std::string& path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+  writeChromeTrace(file);
+  return static_cast<bool>(file.flush());
+}
+
+}  // end of namespace tev
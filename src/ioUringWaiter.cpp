@@ -0,0 +1,245 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of the io_uring deadline wait.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define TEV_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ioUringWaiter.hpp"
+
+namespace tev {
+
+#if defined(TEV_HAS_IO_URING)
+
+namespace {
+constexpr unsigned kEntries{8};
+constexpr std::uint64_t kWakeTag{1};
+constexpr std::uint64_t kIgnoreTag{2};
+constexpr std::uint64_t kTimeoutTag{std::uint64_t{1} << 63};
+
+unsigned loadAcquire(unsigned* value) {
+  return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+}
+void storeRelease(unsigned* value, unsigned next) {
+  std::atomic_ref<unsigned>(*value).store(next, std::memory_order_release);
+}
+}  // namespace
+
+/// Mapped submission and completion rings
+struct IoUringWaiter::Ring {
+  int ringFd{-1};                         ///< io_uring descriptor
+  int wakeFd{-1};                         ///< eventfd of the wake-ups
+  void* rings{MAP_FAILED};                ///< Mapped submission and completion rings
+  std::size_t ringsSize{0};               ///< Bytes of rings
+  io_uring_sqe* sqes{nullptr};            ///< Mapped submission entries
+  std::size_t sqesSize{0};                ///< Bytes of sqes
+  unsigned* sqHead{nullptr};              ///< Submission entries consumed by the kernel
+  unsigned* sqTail{nullptr};              ///< Submission entries queued by us
+  unsigned sqMask{0};                     ///< Index mask of the submission ring
+  unsigned* sqArray{nullptr};             ///< Submission ring, indices into sqes
+  unsigned* cqHead{nullptr};              ///< Completions consumed by us
+  unsigned* cqTail{nullptr};              ///< Completions posted by the kernel
+  unsigned cqMask{0};                     ///< Index mask of the completion ring
+  io_uring_cqe* cqes{nullptr};            ///< Completion ring
+  std::uint64_t wakeCount{0};             ///< Buffer of the eventfd drain
+  __kernel_timespec timeout{};            ///< Deadline of the queued timeout
+  std::uint64_t timeoutSequence{0};       ///< Sequence of the latest timeout
+  bool timeoutPending{false};             ///< Latest timeout not completed yet
+  bool wakeArmed{false};                  ///< eventfd poll in flight
+  int error{0};                           ///< errno of the first failed request or system call
+
+  ~Ring() {
+    // closing the ring cancels the requests in flight before the buffers go away
+    if (ringFd >= 0) {
+      ::close(ringFd);
+    }
+    if (sqes != nullptr) {
+      ::munmap(sqes, sqesSize);
+    }
+    if (rings != MAP_FAILED) {
+      ::munmap(rings, ringsSize);
+    }
+    if (wakeFd >= 0) {
+      ::close(wakeFd);
+    }
+  }
+
+  bool setup() {
+    io_uring_params params{};
+    ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, kEntries, &params));
+    if (ringFd < 0 || (params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+      return false;
+    }
+    ringsSize = std::max<std::size_t>(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                                      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    rings = ::mmap(nullptr, ringsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (rings == MAP_FAILED) {
+      return false;
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* entries =
+        ::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (entries == MAP_FAILED) {
+      return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(entries);
+    auto* base = static_cast<std::byte*>(rings);
+    sqHead = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    sqMask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+    wakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    return wakeFd >= 0;
+  }
+
+  io_uring_sqe& queue(std::uint8_t opcode, std::uint64_t userData) {
+    // at most three entries are queued per wait, the ring never fills up
+    const unsigned tail = *sqTail;
+    const unsigned index = tail & sqMask;
+    io_uring_sqe& sqe = sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = -1;
+    sqe.user_data = userData;
+    sqArray[index] = index;
+    storeRelease(sqTail, tail + 1);
+    return sqe;
+  }
+
+  /// Submits the queued entries and waits for one completion, an interrupted wait is repeated by the caller
+  bool enter() {
+    const unsigned toSubmit = *sqTail - loadAcquire(sqHead);
+    if (::syscall(__NR_io_uring_enter, ringFd, toSubmit, 1U, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+        errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      error = errno;
+      return false;
+    }
+    return true;
+  }
+};
+
+std::unique_ptr<IoUringWaiter> IoUringWaiter::create() {
+  std::unique_ptr<IoUringWaiter> waiter(new IoUringWaiter());
+  waiter->m_Ring = std::make_unique<Ring>();
+  if (!waiter->m_Ring->setup()) {
+    return nullptr;
+  }
+  return waiter;
+}
+
+IoUringWaiter::~IoUringWaiter() = default;
+
+bool IoUringWaiter::waitUntil(TimePoint deadline) {
+  Ring& ring = *m_Ring;
+  if (ring.error != 0) {
+    return false;
+  }
+  if (!ring.wakeArmed) {
+    // a poll waits on every kernel, a read of the non-blocking eventfd fails at once without fast poll
+    io_uring_sqe& poll = ring.queue(IORING_OP_POLL_ADD, kWakeTag);
+    poll.fd = ring.wakeFd;
+    poll.poll_events = POLLIN;
+    ring.wakeArmed = true;
+  }
+  if (ring.timeoutPending) {
+    // a completion of the replaced timeout carries an old sequence and is ignored
+    io_uring_sqe& remove = ring.queue(IORING_OP_TIMEOUT_REMOVE, kIgnoreTag);
+    remove.addr = kTimeoutTag | ring.timeoutSequence;
+  }
+  const auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+  ring.timeout.tv_sec = sinceEpoch / 1'000'000'000;
+  ring.timeout.tv_nsec = sinceEpoch % 1'000'000'000;
+  const std::uint64_t timeoutTag = kTimeoutTag | ++ring.timeoutSequence;
+  io_uring_sqe& timeout = ring.queue(IORING_OP_TIMEOUT, timeoutTag);
+  timeout.addr = reinterpret_cast<std::uint64_t>(&ring.timeout);
+  timeout.len = 1;
+  timeout.timeout_flags = IORING_TIMEOUT_ABS;
+  ring.timeoutPending = true;
+
+  bool woken = false;
+  bool expired = false;
+  while (!woken && !expired && ring.error == 0) {
+    if (!ring.enter()) {
+      break;
+    }
+    unsigned head = *ring.cqHead;
+    const unsigned tail = loadAcquire(ring.cqTail);
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe = ring.cqes[head & ring.cqMask];
+      if (cqe.user_data == kWakeTag) {
+        ring.wakeArmed = false;
+        if (cqe.res < 0) {
+          ring.error = -cqe.res;
+          continue;
+        }
+        woken = true;
+        // reset the counter, the poll would complete again right away
+        (void)!::read(ring.wakeFd, &ring.wakeCount, sizeof(ring.wakeCount));
+      } else if (cqe.user_data == timeoutTag) {
+        ring.timeoutPending = false;
+        // a timeout completes with -ETIME when it expires, anything else is a failed request
+        if (cqe.res == -ETIME) {
+          expired = true;
+        } else {
+          ring.error = cqe.res < 0 ? -cqe.res : EINVAL;
+        }
+      }
+      // completions of replaced timeouts and of their removals carry no information
+    }
+    storeRelease(ring.cqHead, head);
+  }
+  return woken;
+}
+
+int IoUringWaiter::getError() const noexcept {
+  return m_Ring->error;
+}
+
+void IoUringWaiter::wake() noexcept {
+  const std::uint64_t one = 1;
+  (void)!::write(m_Ring->wakeFd, &one, sizeof(one));
+}
+
+#else
+
+struct IoUringWaiter::Ring {};
+
+std::unique_ptr<IoUringWaiter> IoUringWaiter::create() {
+  return nullptr;
+}
+
+IoUringWaiter::~IoUringWaiter() = default;
+
+bool IoUringWaiter::waitUntil(TimePoint) {
+  return false;
+}
+
+int IoUringWaiter::getError() const noexcept {
+  return 0;
+}
+
+void IoUringWaiter::wake() noexcept {}
+
+#endif
+
+}  // end of namespace tev
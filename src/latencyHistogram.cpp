@@ -0,0 +1,59 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of the lock-free latency histograms.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+
+#include "latencyHistogram.hpp"
+
+namespace tev {
+
+LatencyHistogram::Duration LatencyHistogram::Snapshot::percentile(double quantile) const {
+  if (count == 0) {
+    return Duration{0};
+  }
+  // rank of the value, the first value for quantile 0 and the last one for quantile 1
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count))));
+  std::uint64_t seen = 0;
+  for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    seen += counts[bucket];
+    if (seen >= rank) {
+      const auto midpoint = lowestValueOf(bucket) + widthOf(bucket) / 2;
+      return std::clamp(Duration{static_cast<Duration::rep>(midpoint)}, min, max);
+    }
+  }
+  return max;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+  Snapshot snapshot;
+  // the count is the sum of the copied buckets, so the quantiles see a consistent set of values
+  for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    snapshot.counts[bucket] = m_Counts[bucket].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.counts[bucket];
+  }
+  snapshot.total = Duration{static_cast<Duration::rep>(m_Total.load(std::memory_order_relaxed))};
+  const auto min = m_Min.load(std::memory_order_relaxed);
+  snapshot.min = snapshot.count != 0 && min != std::numeric_limits<std::uint64_t>::max()
+                     ? Duration{static_cast<Duration::rep>(min)}
+                     : Duration{0};
+  snapshot.max = Duration{static_cast<Duration::rep>(m_Max.load(std::memory_order_relaxed))};
+  return snapshot;
+}
+
+void LatencyHistogram::reset() noexcept {
+  for (auto& bucket : m_Counts) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_Total.store(0, std::memory_order_relaxed);
+  m_Min.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+  m_Max.store(0, std::memory_order_relaxed);
+}
+
+}  // end of namespace tev
@@ -1,6 +1,5 @@
 #include <any>
 #include <chrono>
-#include <cmath>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -27,301 +26,223 @@ struct MyUserData : public IUserData {
   uint32_t counter{0};  // Sample event type
 };
 
-// Function to calculate the statistics of jitter
-void calculateJitterStatistics(const std::vector<float>& jitterValues) {
-  if (jitterValues.empty()) {
-    std::cout << "No jitter data collected.\n";
-    return;
-  }
-
-  // Calculate min, max, and average jitter
-  float minJitter = *std::min_element(jitterValues.begin(), jitterValues.end());
-  float maxJitter = *std::max_element(jitterValues.begin(), jitterValues.end());
-  float sumJitter = 0.0f;
-  for (float jitter : jitterValues) {
-    sumJitter += jitter;
-  }
-  float averageJitter = jitterValues.empty() ? 0.0f : sumJitter / static_cast<float>(jitterValues.size());
-
-  // Calculate standard deviation of jitter
-  float squaredSum = 0.0f;
-  for (float jitter : jitterValues) {
-    squaredSum += (jitter - averageJitter) * (jitter - averageJitter);
-  }
-  float standardDeviation =
-      jitterValues.empty() ? 0.0f : std::sqrt(squaredSum / static_cast<float>(jitterValues.size()));
-
-  // Print results
-  std::cout << "===================================\n";
-  std::cout << "Jitter Statistics for Total Test:\n";
-  std::cout << "  Min Jitter: " << minJitter << " ms\n";
-  std::cout << "  Max Jitter: " << maxJitter << " ms\n";
-  std::cout << "  Average Jitter: " << averageJitter << " ms\n";
-  std::cout << "  Standard Deviation: " << standardDeviation << " ms\n";
-}
-
 int main() {
-  // Instantiate scheduler
-  Scheduler scheduler;
-  // Vector to store jitter values for each event
-  std::vector<float> jitterValues;
+  // Instantiate scheduler, it traces the event lifecycles
+  Scheduler::Config config;
+  config.traceCapacity = 4096;
+  Scheduler scheduler(config);
 
   // Create controller and user data instances
   auto controller = std::make_shared<MyController>();
   auto userData = std::make_shared<MyUserData>();
 
-  auto process_print = [&]([[maybe_unused]] EventPtr e) {
-    // Get the current time
-    auto now = std::chrono::steady_clock::now();
-    // Calculate the actual elapsed time since the last processing
-    auto actualInterval = now - e->lastProcTimePoint();
-
-    // Calculate jitter: the difference between scheduled and actual time as float milliseconds
-    auto jitterDuration =
-        std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(actualInterval - e->getServeInterval());
-
-    // Output the jitter as float ms
-    // std::cout << "   > intervall " << e->getServeInterval().count() << " ms. Jitter: " << jitterDuration.count()
-    //           << " ms\n";
-    // Store jitter in the vector
-    jitterValues.push_back(jitterDuration.count());
-
-    std::shared_ptr<MyController> myController = std::dynamic_pointer_cast<MyController>(e->getController());
-    if (myController) {
-      // successful cast, safe to use myController
-      myController->handleEvent();
-    } else {
-      // cast failed, handle error
-    }
-    std::shared_ptr<MyUserData> myUserData = std::dynamic_pointer_cast<MyUserData>(e->getUserData());
-    if (myUserData) {
-      // successful cast, safe to use myController
-      myUserData->counter++;
-    }
+  auto process_print = [&](const EventPtr&, MyController& myController, MyUserData& myUserData) {
+    // the typed config hands over the concrete types, no cast needed
+    myController.handleEvent();
+    myUserData.counter++;
   };
 
-  auto start_print = [=]([[maybe_unused]] EventPtr e) {
-    // Get the current time
-    auto now = std::chrono::steady_clock::now();
-    // Calculate the actual elapsed time since the last processing
-    auto actualInterval = now - e->lastProcTimePoint();
-
-    // Calculate jitter: the difference between scheduled and actual time as float milliseconds
-    auto jitterDuration =
-        std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(e->getStartDelay() - actualInterval);
-
-    // Output the jitter as float ms
-    // std::cout << "   > intervall " << e->getStartDelay().count() << " ms. Jitter: " << jitterDuration.count()
-    //           << " ms\n";
-
-    std::shared_ptr<MyController> myController = std::dynamic_pointer_cast<MyController>(e->getController());
-    if (myController) {
-      // successful cast, safe to use myController
-      myController->startEvent();
-    } else {
-      // cast failed, handle error
-    }
+  auto start_print = [=](const EventPtr&, MyController& myController) {
+    // the scheduler records how late the start delay elapsed
+    myController.startEvent();
   };
 
-  auto timeout_print = [&]([[maybe_unused]] EventPtr e) {
-    std::shared_ptr<MyUserData> myUserData = std::dynamic_pointer_cast<MyUserData>(e->getUserData());
-    if (myUserData) {
-      // print
-      std::cout << "   > timeout with counter " << myUserData->counter << "\n";
-    }
+  auto timeout_print = [&](MyUserData& myUserData) {
+    // print
+    std::cout << "   > timeout with counter " << myUserData.counter << "\n";
   };
 
   // Use std::array to store the EventConfig objects for 10 events
-  std::array<EventConfig, 10> configs = {{
+  std::array<TypedEventConfig<MyController, MyUserData>, 10> configs = {{
       {0ms, 1100ms, 6666ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 0 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 0 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 0 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 0 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 0 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {200ms, 888ms, 7050ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 1 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 1 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 1 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 1 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 1 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {400ms, 1000ms, 7111ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 2 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 2 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 2 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 2 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 2 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {600ms, 975ms, 8200ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 3 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 3 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 3 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 3 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 3 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {800ms, 950ms, 9000ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 4 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 4 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 4 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 4 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 4 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {1000ms, 925ms, 9100ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 5 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 5 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 5 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 5 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 5 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {1100ms, 900ms, 9500ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 6 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 6 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 6 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 6 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 6 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {1200ms, 875ms, 8050ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 7 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 7 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 7 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 7 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 7 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {1300ms, 850ms, 8111ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 8 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 8 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 8 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 8 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 8 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
       {1400ms, 825ms, 7777ms,
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData&) {
          std::cout << "Event 9 started\n";
-         start_print(e);
+         start_print(e, controller);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr& e, MyController& controller, MyUserData& data) {
          std::cout << "Event 9 running\n";
-         process_print(e);
+         process_print(e, controller, data);
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 9 aborted\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [](const EventPtr&, MyController&, MyUserData&) {
          std::cout << "Event 9 completed\n";
        },
-       [=]([[maybe_unused]] EventPtr e) {
+       [=](const EventPtr&, MyController&, MyUserData& data) {
          std::cout << "Event 9 time out\n";
-         timeout_print(e);
+         timeout_print(data);
        }},
   }};
 
@@ -347,8 +268,13 @@ int main() {
   std::cout << "Terminating scheduler\n";
   scheduler.terminate();
 
-  // Compute and display jitter statistics for the total test
-  calculateJitterStatistics(jitterValues);
+  // the callbacks print, which dominates their timing; latency_harness measures the timer accuracy
+  std::cout << "Missed Periods: " << scheduler.getMissedPeriods() << "\n";
+
+  // open in Perfetto or chrome://tracing
+  if (scheduler.getTracer()->writeFile("eventScheduler.trace.json")) {
+    std::cout << "Trace written to eventScheduler.trace.json\n";
+  }
 
   return 0;
 }
@@ -0,0 +1,148 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations for the counters and gauges of a scheduler.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "schedulerMetrics.hpp"
+
+namespace tev {
+
+namespace {
+
+/// One exported value with its name and description
+struct Metric {
+  std::string_view name;  ///< Name without prefix
+  std::string_view help;  ///< Description
+  bool counter;           ///< Counter or gauge
+  std::uint64_t count;    ///< Value of counts
+  double seconds;         ///< Value of durations, used if isDuration
+  bool isDuration;        ///< Value is a duration in seconds
+};
+
+Metric counterOf(std::string_view name, std::string_view help, std::uint64_t value) {
+  return Metric{name, help, true, value, 0.0, false};
+}
+Metric gaugeOf(std::string_view name, std::string_view help, std::uint64_t value) {
+  return Metric{name, help, false, value, 0.0, false};
+}
+Metric secondsOf(std::string_view name, std::string_view help, bool counter, SchedulerMetrics::Duration value) {
+  return Metric{name, help, counter, 0, std::chrono::duration<double>(value).count(), true};
+}
+
+std::array<Metric, 22> listMetrics(const SchedulerMetrics& metrics) {
+  return {
+      counterOf("passes_total", "Processing passes", metrics.passes),
+      counterOf("idle_passes_total", "Passes which invoked no callback", metrics.idlePasses),
+      counterOf("callbacks_total", "Callbacks invoked inline or handed to the workers", metrics.callbacks),
+      counterOf("pushes_total", "Applied pushes", metrics.pushes),
+      counterOf("erases_total", "Events removed by erases by event or by user data", metrics.erases),
+      counterOf("cancels_total", "Events removed by cancels of their handle", metrics.cancels),
+      counterOf("completed_total", "Events finished in status Completed", metrics.completed),
+      counterOf("aborted_total", "Events finished in status Aborted", metrics.aborted),
+      counterOf("timed_out_total", "Events finished in status Timeouted", metrics.timedOut),
+      counterOf("missed_periods_total", "Periods dropped by the catch-up policies", metrics.missedPeriods),
+      secondsOf("lock_wait_seconds_total", "Time spent waiting for the scheduler lock", true, metrics.lockWait),
+      secondsOf("lock_wait_seconds_max", "Longest wait for the scheduler lock", false, metrics.lockWaitMax),
+      secondsOf("lock_hold_seconds_total", "Time the scheduler lock was held", true, metrics.lockHold),
+      secondsOf("lock_hold_seconds_max", "Longest hold of the scheduler lock", false, metrics.lockHoldMax),
+      counterOf("deadline_wakeups_total", "Waits ended by their deadline", metrics.deadlineWakeUps),
+      counterOf("notified_wakeups_total", "Waits ended by a wake-up", metrics.notifiedWakeUps),
+      counterOf("push_wake_requests_total", "Pushes due before the sleep deadline", metrics.pushWakeRequests),
+      counterOf("rearm_wake_requests_total", "Re-arms from the workers which woke the thread",
+                metrics.rearmWakeRequests),
+      gaugeOf("events", "Queued and in-flight events", metrics.events),
+      gaugeOf("in_flight", "Events whose callback runs on a worker", metrics.inFlight),
+      gaugeOf("pending_pushes", "Pushes not applied yet", metrics.pendingPushes),
+      gaugeOf("max_queue_depth", "Largest number of queued events after a pass", metrics.maxQueueDepth),
+  };
+}
+
+void writeValue(std::ostringstream& out, const Metric& metric) {
+  if (metric.isDuration) {
+    out << metric.seconds;
+  } else {
+    out << metric.count;
+  }
+}
+
+}  // namespace
+
+SchedulerMetrics& SchedulerMetrics::operator+=(const SchedulerMetrics& other) {
+  passes += other.passes;
+  idlePasses += other.idlePasses;
+  callbacks += other.callbacks;
+  pushes += other.pushes;
+  erases += other.erases;
+  cancels += other.cancels;
+  completed += other.completed;
+  aborted += other.aborted;
+  timedOut += other.timedOut;
+  missedPeriods += other.missedPeriods;
+  lockWait += other.lockWait;
+  lockWaitMax = std::max(lockWaitMax, other.lockWaitMax);
+  lockHold += other.lockHold;
+  lockHoldMax = std::max(lockHoldMax, other.lockHoldMax);
+  deadlineWakeUps += other.deadlineWakeUps;
+  notifiedWakeUps += other.notifiedWakeUps;
+  pushWakeRequests += other.pushWakeRequests;
+  rearmWakeRequests += other.rearmWakeRequests;
+  events += other.events;
+  inFlight += other.inFlight;
+  pendingPushes += other.pendingPushes;
+  maxQueueDepth = std::max(maxQueueDepth, other.maxQueueDepth);
+  return *this;
+}
+
+std::string SchedulerMetrics::toPrometheus(std::string_view prefix) const {
+  std::ostringstream out;
+  out.precision(9);
+  for (const auto& metric : listMetrics(*this)) {
+    out << "# HELP " << prefix << '_' << metric.name << ' ' << metric.help << '\n';
+    out << "# TYPE " << prefix << '_' << metric.name << ' ' << (metric.counter ? "counter" : "gauge") << '\n';
+    out << prefix << '_' << metric.name << ' ';
+    writeValue(out, metric);
+    out << '\n';
+  }
+  return out.str();
+}
+
+std::string SchedulerMetrics::toJson() const {
+  std::ostringstream out;
+  out.precision(9);
+  out << '{';
+  bool first = true;
+  for (const auto& metric : listMetrics(*this)) {
+    out << (first ? "" : ",") << '"' << metric.name << "\":";
+    writeValue(out, metric);
+    first = false;
+  }
+  out << "}\n";
+  return out.str();
+}
+
+bool SchedulerMetrics::writeFile(const std::string& path, Format format) const {
+  // readers never see a partly written file
+  const auto temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::trunc);
+    if (!file) {
+      return false;
+    }
+    file << (format == Format::Prometheus ? toPrometheus() : toJson());
+    if (!file.flush()) {
+      return false;
+    }
+  }
+  return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+}  // end of namespace tev
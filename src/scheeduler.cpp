@@ -6,13 +6,23 @@
 //-----------------------------------------------------------------------------
 // includes <...>
 //-----------------------------------------------------------------------------
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cerrno>
 #include <chrono>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
 
 #include "scheduler.hpp"
+#include "timingWheel.hpp"
 
 using namespace std::chrono_literals;
 
@@ -21,32 +31,117 @@ using namespace std::chrono_literals;
 //----------------------------------------------------------------------------
 namespace tev {
 
+namespace {
+/// Tells the core that the thread busy-waits, saves power and frees resources for a sibling hyper-thread
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/// Restricts a thread to one CPU, systems without thread affinity leave it unpinned
+bool pinThread(std::jthread& thread, int cpu) {
+#if defined(__linux__)
+  if (cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(static_cast<std::size_t>(cpu), &cpus);
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) == 0;
+#else
+  (void)thread;
+  (void)cpu;
+  return true;
+#endif
+}
+}  // namespace
+
+Scheduler::Scheduler(QueueMode queueMode) : Scheduler(Config{queueMode}) {}
+
+Scheduler::Scheduler(const Config& config)
+    : m_Config(config), m_Clock(config.clock ? config.clock : SteadyClock::instance()), m_Handles(config.handleTag) {
+  switch (m_Config.queueMode) {
+    case QueueMode::TimingWheel:
+      m_scheduledEvents = std::make_unique<TimingWheel>(m_Config.wheelResolution, currentTime());
+      break;
+    case QueueMode::Heap:
+      m_scheduledEvents = std::make_unique<EventHeap>();
+      break;
+  }
+  if (m_Config.executionMode != ExecutionMode::Inline) {
+    const auto threads = m_Config.workerThreads != 0 ? m_Config.workerThreads : std::thread::hardware_concurrency();
+    m_Pool = std::make_unique<WorkerPool>(threads);
+  }
+  if (m_Config.executionMode == ExecutionMode::Strand) {
+    m_Strands = std::make_unique<StrandExecutor>(*m_Pool);
+  }
+  if (m_Config.eventStorage == EventStorage::Slab) {
+    m_EventPool = std::make_shared<SlabPool>(kEventBlockSize);
+  }
+  if (m_Config.timerFd) {
+    m_TimerFd = std::make_unique<TimerFd>();
+  }
+  if (m_Config.traceCapacity != 0) {
+    m_Tracer = std::make_unique<EventTracer>(m_Config.traceCapacity, m_Clock);
+  }
+  if (m_Config.waitStrategy == WaitStrategy::IoUring) {
+    m_Ring = IoUringWaiter::create();
+    if (!m_Ring) {
+      // no io_uring in this kernel or forbidden for this process
+      m_Config.waitStrategy = WaitStrategy::Sleep;
+    }
+  }
+}
+
 bool Scheduler::start() {
   if (m_Thread.get_id() != std::jthread::id{}) {
     return false;  // Scheduler is already running
   }
+  if (!m_Clock->isRealTime()) {
+    return false;  // the thread could not wait for a deadline of virtual time
+  }
   m_Thread = std::jthread([this](const std::stop_token& stop_token) {
+    if (m_Tracer) {
+      m_Tracer->nameThread("scheduler");
+    }
     // Register a stop callback
     std::stop_callback stopCb(stop_token, [&]() {
       // Wake thread on stop request
-      m_CondEvent.notify_all();
+      wakeUp();
     });
 
     while (true) {
-      // serve events
-      DurationUnit waitTime = processEvents(m_MaxInterval);
-      // wait next serve
-      {
-        std::unique_lock lock(m_CondMutex);
-        m_CondEvent.wait_for(lock, waitTime);
-      }
-      //Stop if requested to stop
+      // a wake-up from here on ends the wait below, also if it comes while the pass runs
+      const auto token = m_Wake.prepare();
+      //Stop if requested to stop, a later request wakes the wait through the token
       if (stop_token.stop_requested()) {
         break;
       }
+      // serve events, without events the thread sleeps until a push wakes it
+      auto deadline = runPass().value_or(TimePoint::max());
+      if (m_Config.waitStrategy == WaitStrategy::SleepUntil) {
+        // the sleep cannot be woken, pushes are noticed after the maximum interval at the latest
+        deadline = std::min(deadline, currentTime() + m_MaxInterval);
+      }
+      if (m_Tracer) {
+        m_Tracer->sleep();
+      }
+      const bool notified = waitForPass(token, deadline, stop_token);
+      if (m_Tracer) {
+        m_Tracer->wake(notified);
+      }
+      (notified ? m_Metrics.notifiedWakeUps : m_Metrics.deadlineWakeUps).fetch_add(1, std::memory_order_relaxed);
     }
   });
 
+  if (m_Config.cpu >= 0 && !pinThread(m_Thread, m_Config.cpu)) {
+    // no such CPU or not in the allowed set, joins the thread so that start() can be retried
+    m_Thread = std::jthread{};
+    return false;
+  }
   return true;
 }
 
@@ -57,185 +152,809 @@ void Scheduler::terminate() {
   }
 }
 
-void Scheduler::pushEvent(std::shared_ptr<Event> event) {
-  const std::lock_guard lg(m_Mutex);
+void Scheduler::stop() {
+  // requests the stop and joins
+  m_Thread = std::jthread{};
+}
 
-  // set now
-  event->setLastProcTimePoint(std::chrono::steady_clock::now());
-  // set life clock
-  if (event->getEventClock().Timeout<>() != std::chrono::milliseconds::min()) {
-    event->getEventClock().Start();
+/**
+ * @brief Waits for the next pass with the configured wait strategy.
+ * @details Returns at the deadline, on a wake-up after the token was taken or on a stop request.
+ * TimePoint::max() waits for a wake-up only. SleepUntil only returns at the deadline.
+ * @return true if woken before the deadline
+ */
+bool Scheduler::waitForPass(WakeSignal::Token token, TimePoint deadline, const std::stop_token& stopToken) {
+  switch (m_Config.waitStrategy) {
+    case WaitStrategy::SleepUntil: {
+#if defined(__linux__)
+      const auto sinceEpoch =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(steadyDeadline(deadline).time_since_epoch());
+      timespec absolute{};
+      absolute.tv_sec = static_cast<time_t>(sinceEpoch.count() / 1'000'000'000);
+      absolute.tv_nsec = static_cast<long>(sinceEpoch.count() % 1'000'000'000);
+      // steady_clock is CLOCK_MONOTONIC, an absolute deadline does not drift with the time spent on wake-up
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &absolute, nullptr) == EINTR) {
+      }
+#else
+      std::this_thread::sleep_until(steadyDeadline(deadline));
+#endif
+      return false;
+    }
+    case WaitStrategy::BusyPoll:
+      return spinUntil(token, deadline, stopToken);
+    case WaitStrategy::IoUring:
+      // stop requests wake the ring through wakeUp()
+      if (m_Ring->getError() == 0) {
+        return m_Ring->waitUntil(steadyDeadline(deadline));
+      }
+      // a failed ring is left for the condition variable, wakeUp() notifies both
+      [[fallthrough]];
+    case WaitStrategy::Sleep:
+    case WaitStrategy::SleepThenSpin: {
+      const auto spin = m_Config.waitStrategy == WaitStrategy::SleepThenSpin ? m_Config.spinThreshold : DurationUnit{0};
+      const auto sleepDeadline = deadline == TimePoint::max() ? deadline : deadline - spin;
+      // stop requests wake the signal through wakeUp()
+      if (m_Wake.waitUntil(token, steadyDeadline(sleepDeadline))) {
+        return true;
+      }
+      // the sleep ends early, the wake-up latency of the scheduler is spent before the deadline
+      return spin > DurationUnit{0} && spinUntil(token, deadline, stopToken);
+    }
   }
-  if (event->getLifeClock().Timeout<>() != std::chrono::milliseconds::min()) {
-    event->getLifeClock().Start();
+  return false;
+}
+
+/**
+ * @brief Busy-waits for the deadline, a wake-up or a stop request.
+ * @return false if the deadline was reached
+ */
+bool Scheduler::spinUntil(WakeSignal::Token token, TimePoint deadline, const std::stop_token& stopToken) {
+  while (currentTime() < deadline) {
+    if (m_Wake.notified(token) || stopToken.stop_requested()) {
+      return true;
+    }
+    cpuRelax();
   }
-  // set start delay
-  if (event->getStartDelay() != std::chrono::milliseconds::min()) {
-    event->setStatus(Event::Status::Pending);
-  } else {
-    event->setStatus(Event::Status::Running);
+  return false;
+}
+
+/**
+ * @brief Converts a deadline of m_Clock to steady_clock, the clock of the system calls waiting for it.
+ * @details The real-time clocks share the epoch of steady_clock but may deviate from it, the coarse
+ * clock lags by up to a tick, so only the time remaining on m_Clock is carried over.
+ */
+Scheduler::TimePoint Scheduler::steadyDeadline(TimePoint deadline) const noexcept {
+  if (deadline == TimePoint::max() || m_Clock == SteadyClock::instance()) {
+    return deadline;
   }
-  // add event to the list
-  m_scheduledEvents.push_back(event);
-  // notify the scheduler thread
-  wakeUp();
+  const auto steadyNow = std::chrono::steady_clock::now();
+  return steadyNow + (deadline - currentTime());
 }
 
-std::shared_ptr<Event> Scheduler::pushEvent(std::shared_ptr<IController> controller,
-                                            std::shared_ptr<IUserData> userData, const EventConfig& config) {
-  auto newEvent = std::make_shared<Event>(controller, userData, config);
+EventHandle Scheduler::pushEvent(std::shared_ptr<Event> event) {
+  if (!event) {
+    return EventHandle{};
+  }
+  // every push owns the slot it acquires, the pass applying it turns the handle of the previous push stale
+  const auto handle = m_Handles.acquire(event.get());
+  event->setHandle(handle);
+  m_PendingPushes.fetch_add(1, std::memory_order_release);
+  const auto now = currentTime();
+  const auto deadline = firstDeadline(*event, now);
+  submitCommand(Command{.kind = Command::Kind::Push, .event = std::move(event), .timePoint = now, .handle = handle},
+                deadline);
+  return handle;
+}
 
+std::shared_ptr<Event> Scheduler::pushEvent(const std::shared_ptr<IController>& controller,
+                                            const std::shared_ptr<IUserData>& userData, const EventConfig& config) {
+  auto newEvent = makeEvent(controller, userData, config);
   pushEvent(newEvent);
   return newEvent;
 }
 
-void Scheduler::eraseEvent(std::shared_ptr<Event> event) {
-  const std::lock_guard lg(m_Mutex);
-  std::erase_if(m_scheduledEvents, [&](const std::shared_ptr<Event>& event_item) {
-    if (event_item == event) {
-      return true;  // Remove event from a list
+std::size_t Scheduler::pushEvents(std::span<const std::shared_ptr<Event>> events) {
+  const auto now = currentTime();
+  auto earliest = TimePoint::max();
+  decltype(m_Commands)::Batch batch(m_Commands);
+  std::size_t count = 0;
+  for (const auto& event : events) {
+    if (!event) {
+      continue;
     }
-    return false;
-  });
+    const auto handle = m_Handles.acquire(event.get());
+    event->setHandle(handle);
+    earliest = std::min(earliest, firstDeadline(*event, now));
+    batch.add(Command{.kind = Command::Kind::Push, .event = event, .timePoint = now, .handle = handle});
+    ++count;
+  }
+  // counted before the commands are visible, like pushEvent()
+  m_PendingPushes.fetch_add(count, std::memory_order_release);
+  m_Commands.push(batch);
+  wakeForCommand(Command::Kind::Push, earliest);
+  return count;
+}
+
+std::vector<std::shared_ptr<Event>> Scheduler::pushEvents(const std::shared_ptr<IController>& controller,
+                                                          const std::shared_ptr<IUserData>& userData,
+                                                          std::span<const EventConfig> configs) {
+  std::vector<std::shared_ptr<Event>> events;
+  events.reserve(configs.size());
+  for (const auto& config : configs) {
+    events.push_back(makeEvent(controller, userData, config));
+  }
+  pushEvents(events);
+  return events;
+}
+
+/**
+ * @brief Creates an event in the storage of the scheduler.
+ */
+EventPtr Scheduler::makeEvent(const std::shared_ptr<IController>& controller,
+                              const std::shared_ptr<IUserData>& userData, const EventConfig& config) {
+  // the slab storage co-allocates the event and its control block in one pool block
+  return m_EventPool ? std::allocate_shared<Event>(SlabAllocator<Event>(m_EventPool), controller, userData, config)
+                     : std::make_shared<Event>(controller, userData, config);
+}
+
+void Scheduler::reserve(std::size_t count) {
+  if (m_EventPool) {
+    m_EventPool->reserve(count);
+  }
+  m_Commands.reserve(count);
+  const std::lock_guard lg(m_Mutex);
+  m_scheduledEvents->reserve(count);
+}
+
+void Scheduler::eraseEvent(std::shared_ptr<Event> event) {
+  if (event) {
+    submitCommand(Command{.kind = Command::Kind::EraseEvent,
+                          .event = std::move(event),
+                          .timePoint = currentTime()},
+                  TimePoint::max());
+  }
 }
 
 void Scheduler::eraseEvent(std::shared_ptr<IUserData> userData) {
   if (userData) {
-    const std::lock_guard lg(m_Mutex);
-    std::erase_if(m_scheduledEvents, [&](const std::shared_ptr<Event>& event_item) {
-      if (userData == event_item->getUserData()) {
-        return true;  // Remove event from a list
-      }
-      return false;
-    });
+    submitCommand(Command{.kind = Command::Kind::EraseUserData,
+                          .userData = std::move(userData),
+                          .timePoint = currentTime()},
+                  TimePoint::max());
+  }
+}
+
+void Scheduler::eraseEvents(std::span<const std::shared_ptr<Event>> events) {
+  const auto now = currentTime();
+  decltype(m_Commands)::Batch batch(m_Commands);
+  for (const auto& event : events) {
+    if (event) {
+      batch.add(Command{.kind = Command::Kind::EraseEvent, .event = event, .timePoint = now});
+    }
+  }
+  m_Commands.push(batch);
+}
+
+bool Scheduler::cancelEvent(const EventHandle& handle) {
+  if (!m_Handles.isLive(handle)) {
+    return false;
   }
+  submitCommand(Command{.kind = Command::Kind::Cancel, .timePoint = currentTime(), .handle = handle},
+                TimePoint::max());
+  return true;
 }
 
 /**
- * @brief Service function to process timed events.
- * @return Minimum delay for the next event.
+ * @brief Hands a command over to the processing pass.
+ * @details Lock-free, callable from any thread including callbacks. The scheduler thread is only
+ * woken if the command may need service before the deadline it sleeps until, other commands are
+ * applied by the next pass. Removals never need an earlier pass and pass TimePoint::max().
+ * @param deadline - earliest point in time at which the command may need service
  */
-std::chrono::milliseconds Scheduler::processEvents(std::chrono::milliseconds processingTime) {
-  // invoke start function
-  [[maybe_unused]] auto invokeStartFunction = [this](const std::shared_ptr<Event>& it) {
-    if (it->getStartFunc()) {
-      it->getStartFunc()(it);
-    }
-    it->setLastProcTimePoint(std::chrono::steady_clock::now());
-  };
-  // invoke event function
-  [[maybe_unused]] auto invokeEventFunction = [this](const std::shared_ptr<Event>& it) {
-    if (it->getEventFunc()) {
-      it->getEventFunc()(it);
-    }
-    it->setLastProcTimePoint(std::chrono::steady_clock::now());
-  };
-  // invoke timeout function
-  [[maybe_unused]] auto invokeTimeoutFunction = [this](const std::shared_ptr<Event>& it) {
-    if (it->getTimeoutFunc()) {
-      it->getTimeoutFunc()(it);
+void Scheduler::submitCommand(Command command, TimePoint deadline) {
+  const auto kind = command.kind;
+  m_Commands.push(std::move(command));
+  wakeForCommand(kind, deadline);
+}
+
+/**
+ * @brief Wakes the scheduler thread if submitted commands may need service before it wakes anyway.
+ * @param deadline - earliest point in time at which the commands may need service
+ */
+void Scheduler::wakeForCommand(Command::Kind kind, TimePoint deadline) {
+  // pairs with the fence in runPass(): either the pass sees the command or this sees the pass running
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (deadline < m_SleepDeadline.load(std::memory_order_relaxed)) {
+    auto& requests = kind == Command::Kind::Rearm ? m_Metrics.rearmWakeRequests : m_Metrics.pushWakeRequests;
+    requests.fetch_add(1, std::memory_order_relaxed);
+    wakeUp();
+  }
+}
+
+/**
+ * @brief Applies the submitted commands in submission order.
+ * @details Must be called with m_Mutex held, m_Mutex makes the caller the single consumer.
+ * @return Number of applied pushes.
+ */
+std::size_t Scheduler::applyCommands() {
+  std::size_t appliedPushes = 0;
+  Command command;
+  while (m_Commands.pop(command)) {
+    switch (command.kind) {
+      case Command::Kind::Push:
+        armEvent(std::move(command.event), command.handle, command.timePoint);
+        ++appliedPushes;
+        break;
+      case Command::Kind::EraseEvent:
+        if (removeEvent(*command.event)) {
+          m_Metrics.erases.fetch_add(1, std::memory_order_relaxed);
+        }
+        break;
+      case Command::Kind::EraseUserData: {
+        auto erased = m_scheduledEvents->eraseIf([&](const std::shared_ptr<Event>& event_item) {
+          if (command.userData != event_item->getUserData()) {
+            return false;
+          }
+          m_Handles.release(event_item->getArmedHandle());
+          return true;
+        });
+        erased += std::erase_if(m_InFlight, [&](Event* event_item) {
+          if (command.userData != event_item->getUserData()) {
+            return false;
+          }
+          m_Handles.release(event_item->getArmedHandle());
+          return true;
+        });
+        m_Metrics.erases.fetch_add(erased, std::memory_order_relaxed);
+        break;
+      }
+      case Command::Kind::Cancel:
+        // a stale handle is ignored, its event finished before the cancel was applied
+        if (auto* event = m_Handles.get(command.handle)) {
+          if (removeEvent(*event)) {
+            m_Metrics.cancels.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+        break;
+      case Command::Kind::Rearm:
+        finishCallback(std::move(command.event), command.finished, command.timePoint);
+        break;
     }
-    it->setLastProcTimePoint(std::chrono::steady_clock::now());
-  };
-  // invoke complete function
-  [[maybe_unused]] auto invokeCompleteFunction = [this](const std::shared_ptr<Event>& it) {
-    if (it->getCompleteFunc()) {
-      it->getCompleteFunc()(it);
+    command = Command{};
+  }
+  m_Metrics.pushes.fetch_add(appliedPushes, std::memory_order_relaxed);
+  return appliedPushes;
+}
+
+/**
+ * @brief Starts the clocks of a pushed event and puts it into the queue.
+ * @details Must be called with m_Mutex held.
+ * @param handle - handle acquired by the push
+ * @param now - time the event was pushed
+ */
+void Scheduler::armEvent(EventPtr event, const EventHandle& handle, TimePoint now) {
+  // set now
+  event->setLastProcTimePoint(now);
+  // set life clock
+  if (event->getEventClock().Timeout() != Event::kNoDuration) {
+    event->getEventClock().StartAt(now, event->getEventClock().Timeout());
+  }
+  if (event->getLifeClock().Timeout() != Event::kNoDuration) {
+    event->getLifeClock().StartAt(now, event->getLifeClock().Timeout());
+  }
+  // the handle of the push replaces the one of an earlier push, released unless erased or finished already
+  if (event->getArmedHandle() != handle) {
+    m_Handles.release(event->getArmedHandle());
+    event->setArmedHandle(handle);
+  }
+  // concurrent pushes store their handles in any order, the last applied one stays
+  event->setHandle(handle);
+  // set start delay
+  if (event->hasStartDelay()) {
+    setStatus(*event, Event::Status::Pending);
+    // the start callback is due as soon as the delay is elapsed
+    event->getEventClock().StartAt(now, event->getStartDelay());
+  } else {
+    setStatus(*event, Event::Status::Running);
+  }
+  m_Handles.setStatus(event->getArmedHandle(), event->getStatus());
+  // an event in flight goes back into the queue when its callback returned
+  if (m_InFlight.contains(event.get())) {
+    return;
+  }
+  // add event to the heap
+  const auto deadline = nextDeadline(*event, event->lastProcTimePoint());
+  if (!m_scheduledEvents->update(*event, deadline)) {
+    m_scheduledEvents->push(std::move(event), deadline);
+  }
+}
+
+/**
+ * @brief Takes an event out of the queue and releases its handle.
+ * @details Must be called with m_Mutex held. An event in flight is not re-armed once its
+ * callback returns.
+ * @return false if the event was neither queued nor in flight
+ */
+bool Scheduler::removeEvent(Event& event) {
+  // the queue may hold the last reference, the event must outlive the release of its handle
+  const auto erased = m_scheduledEvents->erase(event);
+  const bool inFlight = m_InFlight.erase(&event) != 0;
+  m_Handles.release(event.getArmedHandle());
+  return erased != nullptr || inFlight;
+}
+
+/**
+ * @brief Calculates the point in time at which the event needs the next service.
+ * @details The earlier of the serve deadline and the life deadline. Events in a final
+ * state and events without a running clock need service immediately.
+ */
+Scheduler::TimePoint Scheduler::serviceDeadline(Event& event, TimePoint now) {
+  switch (event.getStatus()) {
+    case Event::Status::Pending:
+    case Event::Status::Running:
+      break;
+    default:
+      return now;
+  }
+  auto& eventClock = event.getEventClock();
+  if (!eventClock.IsRunning()) {
+    return now;
+  }
+  TimePoint deadline = eventClock.Deadline();
+  if (hasLifeDeadline(event)) {
+    deadline = std::min<TimePoint>(deadline, event.getLifeClock().Deadline());
+  }
+  return deadline;
+}
+
+/**
+ * @brief Calculates the queue deadline of the event, its service deadline moved within its slack.
+ */
+Scheduler::TimePoint Scheduler::nextDeadline(Event& event, TimePoint now) {
+  return coalesce(serviceDeadline(event, now), event.getSlack());
+}
+
+/**
+ * @brief Moves a deadline within its slack to a point in time shared by other deadlines.
+ * @details Picks the time in [deadline, deadline + slack] with the most trailing zero bits, like
+ * the timer slack of the Linux kernel. Deadlines close to each other with a similar slack end up
+ * on the same point in time and are served by one pass, without a common grid or a second queue.
+ */
+Scheduler::TimePoint Scheduler::coalesce(TimePoint deadline, DurationUnit slack) {
+  if (slack <= DurationUnit{0}) {
+    return deadline;
+  }
+  const auto earliest = static_cast<std::uint64_t>(deadline.time_since_epoch().count());
+  const auto latest = earliest + static_cast<std::uint64_t>(std::chrono::ceil<TimePoint::duration>(slack).count());
+  // the highest bit in which both differ is set in latest, clearing the bits below stays at or after earliest
+  const auto highestBit = std::bit_width(earliest ^ latest) - 1;
+  const auto mask = (std::uint64_t{1} << highestBit) - 1;
+  return TimePoint(TimePoint::duration(static_cast<TimePoint::rep>(latest & ~mask)));
+}
+
+/**
+ * @brief Calculates the earliest point in time at which a pushed event may need service.
+ * @details Evaluated by the producer before the push is applied, which starts the clocks a bit
+ * later, so the result may be early but is never late.
+ */
+Scheduler::TimePoint Scheduler::firstDeadline(Event& event, TimePoint now) {
+  TimePoint deadline = now;
+  if (event.hasStartDelay() && event.getStartDelay() > DurationUnit{0}) {
+    deadline = now + event.getStartDelay();
+  }
+  const auto life = event.getLifeDuration();
+  if (life > DurationUnit{0} && life != Event::kDefaultEndlessLifeMs) {
+    deadline = std::min(deadline, now + life);
+  }
+  return deadline;
+}
+
+/**
+ * @brief Checks whether the lifetime of the event is limited.
+ */
+bool Scheduler::hasLifeDeadline(Event& event) {
+  auto& lifeClock = event.getLifeClock();
+  return event.getLifeDuration().count() > 0 && lifeClock.IsRunning() &&
+         lifeClock.Timeout() != Event::kDefaultEndlessLifeMs;
+}
+
+/**
+ * @brief Restarts the event clock for the period following its elapsed deadline.
+ * @details Must be called with m_Mutex held. The next period starts at the elapsed deadline
+ * instead of now, so neither the scheduling latency nor the callback runtime shifts the phase.
+ * Further periods which elapsed before now are handled by the catch-up policy of the event.
+ */
+void Scheduler::advancePeriod(Event& event, TimePoint now) {
+  auto& eventClock = event.getEventClock();
+  const auto period = event.getServeInterval();
+  if (period.count() <= 0) {
+    // no period to keep in phase
+    eventClock.StartAt(now, period);
+    return;
+  }
+  const auto deadline = eventClock.Deadline();
+  const auto missed = now > deadline ? (now - deadline) / period : 0;
+  if (missed == 0) {
+    eventClock.StartAt(deadline, period);
+    return;
+  }
+  switch (event.getCatchUpPolicy()) {
+    case CatchUpPolicy::Skip:
+      eventClock.StartAt(deadline + missed * period, period);
+      break;
+    case CatchUpPolicy::FireOnceAndRealign:
+      eventClock.StartAt(now, period);
+      break;
+    case CatchUpPolicy::Burst:
+      // the next deadline is due already, one missed period fires per pass
+      eventClock.StartAt(deadline, period);
+      return;
+  }
+  event.addMissedPeriods(static_cast<std::uint64_t>(missed));
+  m_MissedPeriods.fetch_add(static_cast<std::uint64_t>(missed), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Invokes an event callback if one is set and records its lateness and runtime.
+ * @param deadline - deadline the callback is served for
+ * @param start - current time, the end of the previous callback of a pass or the pass snapshot
+ * @return Time the callback returned, start if there was none, so the clock is read once per callback.
+ */
+Scheduler::TimePoint Scheduler::invokeCallback(const EventPtr& event, ControllerEventCallback* callback,
+                                               TimePoint deadline, TimePoint start) {
+  if (callback == nullptr || !*callback) {
+    event->setLastProcTimePoint(start);
+    return start;
+  }
+  const bool startCallback = callback == &event->getStartFunc() && event->hasStartDelay();
+  const auto status = event->getStatus();
+  if (m_Tracer) {
+    m_Tracer->callbackBegin(event->getHandle(), callbackOf(*event, callback));
+  }
+  (*callback)(event);
+  const auto end = currentTime();
+  if (m_Tracer) {
+    m_Tracer->callbackEnd(event->getHandle(), callbackOf(*event, callback), end);
+    // callbacks complete or abort their event
+    if (event->getStatus() != status) {
+      m_Tracer->status(event->getHandle(), status, event->getStatus(), end);
     }
-    it->setLastProcTimePoint(std::chrono::steady_clock::now());
+  }
+  event->setLastProcTimePoint(end);
+  recordTimes(*event, start - deadline, end - start, startCallback);
+  return end;
+}
+
+/**
+ * @brief Changes the status of an event and traces the transition.
+ */
+void Scheduler::setStatus(Event& event, Event::Status status) {
+  if (m_Tracer && event.getStatus() != status) {
+    m_Tracer->status(event.getHandle(), event.getStatus(), status);
+  }
+  event.setStatus(status);
+}
+
+EventTracer::Callback Scheduler::callbackOf(Event& event, const ControllerEventCallback* callback) {
+  if (callback == &event.getStartFunc()) {
+    return EventTracer::Callback::Start;
+  }
+  if (callback == &event.getCompleteFunc()) {
+    return EventTracer::Callback::Complete;
+  }
+  if (callback == &event.getAbortFunc()) {
+    return EventTracer::Callback::Abort;
+  }
+  if (callback == &event.getTimeoutFunc()) {
+    return EventTracer::Callback::Timeout;
+  }
+  return EventTracer::Callback::Serve;
+}
+
+/**
+ * @brief Puts a served event back into the queue with its next deadline.
+ * @details Must be called with m_Mutex held.
+ */
+void Scheduler::rescheduleEvent(EventPtr event, TimePoint now) {
+  // check timeout
+  if (hasLifeDeadline(*event) && event->getLifeClock().Deadline() <= now) {
+    setStatus(*event, Event::Status::Timeouted);
+  }
+  m_Handles.setStatus(event->getArmedHandle(), event->getStatus());
+  const auto deadline = nextDeadline(*event, now);
+  m_scheduledEvents->push(std::move(event), deadline);
+}
+
+/**
+ * @brief Hands a callback over to the worker pool.
+ * @details Must be called with m_Mutex held. The event stays out of the queue until the
+ * callback returned, so callbacks of one event never run concurrently. In strand mode the
+ * callback is queued on the strand of the event controller.
+ */
+void Scheduler::dispatchCallback(EventPtr event, ControllerEventCallback* callback, bool finished,
+                                 TimePoint deadline) {
+  m_InFlight.insert(event.get());
+  const void* strandKey = event->getController().get();
+  auto task = [this, event = std::move(event), callback, deadline, finished]() mutable {
+    invokeCallback(event, callback, deadline, currentTime());
+    completeCallback(std::move(event), finished);
   };
-  // invoke abort function
-  [[maybe_unused]] auto invokeAbortFunction = [this](const std::shared_ptr<Event>& it) {
-    if (it->getAbortFunc()) {
-      it->getAbortFunc()(it);
+  if (m_Strands) {
+    m_Strands->post(strandKey, std::move(task));
+  } else {
+    m_Pool->submit(std::move(task));
+  }
+}
+
+/**
+ * @brief Reports a callback which returned on a worker thread to the processing pass.
+ * @details Does not take m_Mutex, workers never wait for a pass.
+ */
+void Scheduler::completeCallback(EventPtr event, bool finished) {
+  // the new deadline may be earlier than the one the scheduler waits for, a finished event leaves at once
+  const auto now = currentTime();
+  const auto deadline = finished ? now : nextDeadline(*event, now);
+  submitCommand(Command{.kind = Command::Kind::Rearm, .event = std::move(event), .timePoint = now, .finished = finished},
+                deadline);
+}
+
+/**
+ * @brief Re-arms an event whose callback returned on a worker thread.
+ * @details Must be called with m_Mutex held.
+ */
+void Scheduler::finishCallback(EventPtr event, bool finished, TimePoint now) {
+  if (m_InFlight.erase(event.get()) == 0) {
+    // erased while in flight, the handle is released already
+    return;
+  }
+  if (finished) {
+    m_Handles.release(event->getArmedHandle());
+    return;
+  }
+  rescheduleEvent(std::move(event), now);
+}
+
+/**
+ * @brief Service function to process timed events.
+ * @return Minimum delay for the next event.
+ */
+DurationUnit Scheduler::processEvents(DurationUnit processingTime) {
+  // the next wait time is the distance to the earliest deadline
+  if (const auto earliest = runPass()) {
+    const auto remainingTime = std::chrono::ceil<DurationUnit>(*earliest - currentTime());
+    if (remainingTime < processingTime) {
+      processingTime = remainingTime;
     }
-    it->setLastProcTimePoint(std::chrono::steady_clock::now());
+  }
+  // an event due already is served by the next pass right away
+  return std::max(processingTime, DurationUnit{0});
+}
+
+void Scheduler::processDue() {
+  if (!m_TimerFd) {
+    (void)runPass();
+    return;
+  }
+  m_TimerFd->drain();
+  // wake-ups from here on arm the timerfd again
+  m_TimerFdWake.store(false, std::memory_order_release);
+  if (const auto earliest = runPass()) {
+    // the timerfd runs on CLOCK_MONOTONIC
+    m_TimerFd->arm(steadyDeadline(*earliest));
+  } else {
+    m_TimerFd->disarm();
+  }
+  // a wake-up during the pass may have been overwritten by the arm above
+  if (m_TimerFdWake.load(std::memory_order_acquire)) {
+    m_TimerFd->armNow();
+  }
+}
+
+SchedulerMetrics Scheduler::getMetrics() const {
+  const auto duration = [](const std::atomic<DurationUnit::rep>& value) {
+    return DurationUnit{value.load(std::memory_order_relaxed)};
   };
+  SchedulerMetrics metrics;
+  metrics.passes = m_PassCount.load(std::memory_order_relaxed);
+  metrics.idlePasses = m_Metrics.idlePasses.load(std::memory_order_relaxed);
+  metrics.callbacks = m_Metrics.callbacks.load(std::memory_order_relaxed);
+  metrics.pushes = m_Metrics.pushes.load(std::memory_order_relaxed);
+  metrics.erases = m_Metrics.erases.load(std::memory_order_relaxed);
+  metrics.cancels = m_Metrics.cancels.load(std::memory_order_relaxed);
+  metrics.completed = m_Metrics.completed.load(std::memory_order_relaxed);
+  metrics.aborted = m_Metrics.aborted.load(std::memory_order_relaxed);
+  metrics.timedOut = m_Metrics.timedOut.load(std::memory_order_relaxed);
+  metrics.missedPeriods = m_MissedPeriods.load(std::memory_order_relaxed);
+  metrics.lockWait = duration(m_Metrics.lockWait);
+  metrics.lockWaitMax = duration(m_Metrics.lockWaitMax);
+  metrics.lockHold = duration(m_Metrics.lockHold);
+  metrics.lockHoldMax = duration(m_Metrics.lockHoldMax);
+  metrics.deadlineWakeUps = m_Metrics.deadlineWakeUps.load(std::memory_order_relaxed);
+  metrics.notifiedWakeUps = m_Metrics.notifiedWakeUps.load(std::memory_order_relaxed);
+  metrics.pushWakeRequests = m_Metrics.pushWakeRequests.load(std::memory_order_relaxed);
+  metrics.rearmWakeRequests = m_Metrics.rearmWakeRequests.load(std::memory_order_relaxed);
+  metrics.events = getEventsCount();
+  metrics.inFlight = m_Metrics.inFlight.load(std::memory_order_relaxed);
+  metrics.pendingPushes = m_PendingPushes.load(std::memory_order_relaxed);
+  metrics.maxQueueDepth = m_Metrics.maxQueueDepth.load(std::memory_order_relaxed);
+  return metrics;
+}
+
+/**
+ * @brief Adds the lock times of a pass to the metrics.
+ * @details Called with m_Mutex held, the passes are the only writers.
+ */
+void Scheduler::recordLock(DurationUnit wait, DurationUnit hold) {
+  m_Metrics.lockWait.fetch_add(wait.count(), std::memory_order_relaxed);
+  m_Metrics.lockHold.fetch_add(hold.count(), std::memory_order_relaxed);
+  if (wait.count() > m_Metrics.lockWaitMax.load(std::memory_order_relaxed)) {
+    m_Metrics.lockWaitMax.store(wait.count(), std::memory_order_relaxed);
+  }
+  if (hold.count() > m_Metrics.lockHoldMax.load(std::memory_order_relaxed)) {
+    m_Metrics.lockHoldMax.store(hold.count(), std::memory_order_relaxed);
+  }
+}
 
+Scheduler::LatenessStats Scheduler::getLateness(Priority priority) const {
+  const auto& counters = m_Lateness[static_cast<std::size_t>(priority)];
+  return LatenessStats{.callbacks = counters.callbacks.load(std::memory_order_relaxed),
+                       .total = DurationUnit{counters.total.load(std::memory_order_relaxed)},
+                       .max = DurationUnit{counters.max.load(std::memory_order_relaxed)}};
+}
+
+/**
+ * @brief Adds the timing of a callback to the priority counters and the histograms.
+ * @details Called by the scheduler thread and the workers without a lock.
+ */
+void Scheduler::recordTimes(Event& event, DurationUnit lateness, DurationUnit execution, bool startCallback) {
+  m_Latency.recordCallback(lateness, execution, startCallback);
+  if (auto* latency = event.getLatencyHistograms()) {
+    latency->recordCallback(lateness, execution, startCallback);
+  }
+  auto& counters = m_Lateness[static_cast<std::size_t>(event.getPriority())];
+  const auto late = std::max(lateness.count(), DurationUnit::rep{0});
+  counters.callbacks.fetch_add(1, std::memory_order_relaxed);
+  counters.total.fetch_add(late, std::memory_order_relaxed);
+  auto max = counters.max.load(std::memory_order_relaxed);
+  while (late > max && !counters.max.compare_exchange_weak(max, late, std::memory_order_relaxed)) {
+  }
+}
+
+/**
+ * @brief Orders the due events of a pass by priority and by earliest deadline within a priority.
+ * @details Must be called with m_Mutex held. The events stay in m_DueEvents, m_DueOrder lists
+ * them in serving order along with the deadline each one is served for.
+ */
+void Scheduler::sortDueEvents(TimePoint now) {
+  m_DueOrder.clear();
+  for (std::size_t i = 0; i < m_DueEvents.size(); ++i) {
+    auto& event = *m_DueEvents[i];
+    m_DueOrder.push_back(
+        DueEntry{.priority = event.getPriority(), .deadline = serviceDeadline(event, now), .index = i});
+  }
+  if (m_DueOrder.size() > 1) {
+    std::sort(m_DueOrder.begin(), m_DueOrder.end(), [](const DueEntry& lhs, const DueEntry& rhs) {
+      return lhs.priority != rhs.priority ? lhs.priority < rhs.priority : lhs.deadline < rhs.deadline;
+    });
+  }
+}
+
+/**
+ * @brief Applies the submitted commands and serves the due events.
+ * @return Earliest deadline of the scheduled events, nothing if none is scheduled.
+ */
+std::optional<Scheduler::TimePoint> Scheduler::runPass() {
+  const auto lockRequested = std::chrono::steady_clock::now();
   const std::lock_guard lg(m_Mutex);
+  const auto lockAcquired = std::chrono::steady_clock::now();
+  // until the next deadline is published every submission wakes, the pass may miss it
+  m_SleepDeadline.store(TimePoint::max(), std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  m_PassCount.fetch_add(1, std::memory_order_relaxed);
+
+  // pushes, erases and re-arms submitted since the last pass
+  const auto appliedPushes = applyCommands();
 
-  for (auto it = m_scheduledEvents.begin(); !m_scheduledEvents.empty() && it != m_scheduledEvents.end();) {
-    auto event = *it;
+  // take the due events from the queue, the rest is not touched in this pass
+  const auto now = currentTime();
+  m_DueEvents.clear();
+  m_scheduledEvents->popDue(now, m_DueEvents);
+  sortDueEvents(now);
+
+  // all deadlines of the pass are decided on now, time only follows the inline callbacks for their metrics
+  auto time = now;
+  std::uint64_t callbacks = 0;
+  for (const auto& due : m_DueOrder) {
+    auto& event = m_DueEvents[due.index];
+    ControllerEventCallback* callback = nullptr;
+    bool finished = false;
     switch (event->getStatus()) {
       case Event::Status::Pending:
-        if (event->getStartDelay() > std::chrono::milliseconds::min()) {
+        if (event->hasStartDelay()) {
           if (!event->getEventClock().IsRunning()) {
             // Start the event clock to delay the event
-            event->getEventClock().Start(event->getStartDelay());
+            event->getEventClock().StartAt(now, event->getStartDelay());
             break;
           }
-          if (event->getEventClock().IsElapsed()) {
-            // start
-            invokeStartFunction(event);
-            event->setStatus(Event::Status::Running);
-            event->getEventClock().Start(event->getServeInterval());
+          if (event->getEventClock().Deadline() <= now) {
+            // start, the periods count from the start deadline
+            callback = &event->getStartFunc();
+            setStatus(*event, Event::Status::Running);
+            advancePeriod(*event, now);
             break;
           }
         } else {
           // start immediately
-          invokeStartFunction(event);
-          event->setStatus(Event::Status::Running);
-          event->getEventClock().Start(event->getServeInterval());
+          callback = &event->getStartFunc();
+          setStatus(*event, Event::Status::Running);
+          event->getEventClock().StartAt(now, event->getServeInterval());
         }
         break;
       case Event::Status::Running:
         if (!event->getEventClock().IsRunning()) {
           // start timer
-          event->getEventClock().Start(event->getServeInterval());
-          invokeStartFunction(event);
-        } else if (event->getEventClock().IsElapsed().value()) {
-          invokeEventFunction(event);
-          event->getEventClock().Start(event->getServeInterval());
+          event->getEventClock().StartAt(now, event->getServeInterval());
+          callback = &event->getStartFunc();
+        } else if (event->getEventClock().Deadline() <= now) {
+          advancePeriod(*event, now);
+          callback = &event->getEventFunc();
         }
         break;
       case Event::Status::Completed:
-        invokeCompleteFunction(event);
-        it = m_scheduledEvents.erase(it);
-        continue;
+        callback = &event->getCompleteFunc();
+        finished = true;
+        m_Metrics.completed.fetch_add(1, std::memory_order_relaxed);
+        break;
       case Event::Status::Aborted:
-        invokeAbortFunction(event);
-        it = m_scheduledEvents.erase(it);
-        continue;
+        callback = &event->getAbortFunc();
+        finished = true;
+        m_Metrics.aborted.fetch_add(1, std::memory_order_relaxed);
+        break;
       case Event::Status::Timeouted:
-        invokeTimeoutFunction(event);
-        it = m_scheduledEvents.erase(it);
-        continue;
+        callback = &event->getTimeoutFunc();
+        finished = true;
+        m_Metrics.timedOut.fetch_add(1, std::memory_order_relaxed);
+        break;
       default:
-        it = m_scheduledEvents.erase(it);
-        continue;
-    }
-
-    auto remainingTimeMs = event->getEventClock().LeftTime().count();
-    if (remainingTimeMs < 0) {
-      remainingTimeMs = 0;
-    }
-    // check timeout
-    if (event->getLifeDuration().count() > 0) {
-      if (event->getLifeClock().IsRunning() && event->getLifeClock().IsElapsed().value()) {
-        event->setStatus(Event::Status::Timeouted);
-        remainingTimeMs = 0;
-      } else {
-        auto remainingLifeMs = event->getLifeClock().LeftTime().count();
-        if (remainingLifeMs < 0) {
-          remainingLifeMs = 0;
-        }
-        if (remainingTimeMs > remainingLifeMs) {
-          remainingTimeMs = remainingLifeMs;
-        }
-      }
+        finished = true;
+        break;
     }
 
-    if (remainingTimeMs < processingTime.count()) {
-      processingTime = std::chrono::milliseconds(remainingTimeMs);
+    if (callback != nullptr && *callback) {
+      ++callbacks;
+    }
+    if (m_Pool && callback != nullptr && *callback) {
+      m_Handles.setStatus(event->getArmedHandle(), event->getStatus());
+      dispatchCallback(std::move(event), callback, finished, due.deadline);
+      continue;
+    }
+    if (callback != nullptr) {
+      time = invokeCallback(event, callback, due.deadline, time);
     }
+    if (finished) {
+      m_Handles.release(event->getArmedHandle());
+    } else {
+      rescheduleEvent(std::move(event), now);
+    }
+  }
+  m_DueEvents.clear();
+  // the applied pushes leave the pending count only once they are part of the events count
+  m_EventsCount.store(m_scheduledEvents->size() + m_InFlight.size(), std::memory_order_release);
+  m_PendingPushes.fetch_sub(appliedPushes, std::memory_order_release);
 
-    ++it;
+  m_Metrics.callbacks.fetch_add(callbacks, std::memory_order_relaxed);
+  if (callbacks == 0) {
+    m_Metrics.idlePasses.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_Metrics.inFlight.store(m_InFlight.size(), std::memory_order_relaxed);
+  if (m_scheduledEvents->size() > m_Metrics.maxQueueDepth.load(std::memory_order_relaxed)) {
+    m_Metrics.maxQueueDepth.store(m_scheduledEvents->size(), std::memory_order_relaxed);
   }
-  // Ensure wait time is at least minInterval
-  if (processingTime.count() <= 0)
-    processingTime = 1ms;
 
-  return processingTime;
+  const auto earliest = m_scheduledEvents->earliestDeadline();
+  m_SleepDeadline.store(earliest.value_or(TimePoint::max()), std::memory_order_seq_cst);
+  recordLock(lockAcquired - lockRequested, std::chrono::steady_clock::now() - lockAcquired);
+  return earliest;
 }
 
-}  // namespace tev
+}  // namespace tev
\ No newline at end of file
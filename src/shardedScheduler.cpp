@@ -0,0 +1,200 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations for scheduling events on several scheduler threads.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <thread>
+
+#include "shardedScheduler.hpp"
+
+namespace tev {
+
+ShardedScheduler::ShardedScheduler(const Config& config) : m_Placement(config.placement) {
+  const auto shards = config.shards != 0 ? config.shards : std::max(1U, std::thread::hardware_concurrency());
+  m_Shards.reserve(shards);
+  for (std::size_t i = 0; i < shards; ++i) {
+    auto shardConfig = config.shard;
+    if (!config.cpus.empty()) {
+      shardConfig.cpu = config.cpus[i % config.cpus.size()];
+    }
+    shardConfig.handleTag = static_cast<std::uint32_t>(std::min<std::size_t>(i, EventHandleTable::kMaxTag));
+    m_Shards.push_back(std::make_unique<Scheduler>(shardConfig));
+  }
+}
+
+ShardedHandle ShardedScheduler::pushEvent(std::shared_ptr<Event> event) {
+  if (!event) {
+    return ShardedHandle{};
+  }
+  auto shard = findShard(*event);
+  if (!shard) {
+    shard = placeShard(event->getController().get(), event->getUserData().get());
+  }
+  return ShardedHandle{static_cast<std::uint32_t>(*shard), m_Shards[*shard]->pushEvent(std::move(event))};
+}
+
+ShardedHandle ShardedScheduler::pushEvent(std::uint64_t key, std::shared_ptr<Event> event) {
+  if (!event) {
+    return ShardedHandle{};
+  }
+  const auto shard = findShard(*event).value_or(shardOfKey(key));
+  return ShardedHandle{static_cast<std::uint32_t>(shard), m_Shards[shard]->pushEvent(std::move(event))};
+}
+
+std::shared_ptr<Event> ShardedScheduler::pushEvent(const std::shared_ptr<IController>& controller,
+                                                   const std::shared_ptr<IUserData>& userData,
+                                                   const EventConfig& config) {
+  // the shard creates the event, in the slab storage mode from its own pool
+  return m_Shards[placeShard(controller.get(), userData.get())]->pushEvent(controller, userData, config);
+}
+
+void ShardedScheduler::eraseEvent(const std::shared_ptr<Event>& event) {
+  if (!event) {
+    return;
+  }
+  if (const auto shard = findShard(*event)) {
+    m_Shards[*shard]->eraseEvent(event);
+  }
+}
+
+void ShardedScheduler::eraseEvent(const std::shared_ptr<IUserData>& userData) {
+  // only the UserData placement keeps them on one shard, and events pushed with a key may be anywhere
+  for (auto& shard : m_Shards) {
+    shard->eraseEvent(userData);
+  }
+}
+
+bool ShardedScheduler::cancelEvent(const ShardedHandle& handle) {
+  if (handle.shard >= m_Shards.size()) {
+    return false;
+  }
+  return m_Shards[handle.shard]->cancelEvent(handle.handle);
+}
+
+std::optional<Event::Status> ShardedScheduler::getEventStatus(const ShardedHandle& handle) const {
+  if (handle.shard >= m_Shards.size()) {
+    return std::nullopt;
+  }
+  return m_Shards[handle.shard]->getEventStatus(handle.handle);
+}
+
+void ShardedScheduler::reserve(std::size_t count) {
+  const auto perShard = (count + m_Shards.size() - 1) / m_Shards.size();
+  for (auto& shard : m_Shards) {
+    shard->reserve(perShard);
+  }
+}
+
+bool ShardedScheduler::start() {
+  std::size_t started = 0;
+  const auto rollBack = [&]() {
+    for (std::size_t i = 0; i < started; ++i) {
+      m_Shards[i]->stop();
+    }
+  };
+  try {
+    while (started < m_Shards.size() && m_Shards[started]->start()) {
+      ++started;
+    }
+  } catch (...) {
+    rollBack();
+    throw;
+  }
+  if (started < m_Shards.size()) {
+    rollBack();
+    return false;
+  }
+  return true;
+}
+
+void ShardedScheduler::terminate() {
+  for (auto& shard : m_Shards) {
+    shard->terminate();
+  }
+}
+
+std::optional<std::size_t> ShardedScheduler::findShard(const Event& event) const {
+  const auto handle = event.getHandle();
+  if (!handle.valid()) {
+    return std::nullopt;
+  }
+  const auto tag = std::size_t{EventHandleTable::tagOfHandle(handle)};
+  const auto end = tag < EventHandleTable::kMaxTag ? std::min(tag + 1, m_Shards.size()) : m_Shards.size();
+  for (auto i = tag; i < end; ++i) {
+    if (m_Shards[i]->owns(event)) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+std::size_t ShardedScheduler::getEventsCount() const {
+  std::size_t count = 0;
+  for (const auto& shard : m_Shards) {
+    count += shard->getEventsCount();
+  }
+  return count;
+}
+
+std::uint64_t ShardedScheduler::getPassCount() const {
+  std::uint64_t count = 0;
+  for (const auto& shard : m_Shards) {
+    count += shard->getPassCount();
+  }
+  return count;
+}
+
+std::uint64_t ShardedScheduler::getMissedPeriods() const {
+  std::uint64_t count = 0;
+  for (const auto& shard : m_Shards) {
+    count += shard->getMissedPeriods();
+  }
+  return count;
+}
+
+Scheduler::LatenessStats ShardedScheduler::getLateness(Priority priority) const {
+  Scheduler::LatenessStats stats;
+  for (const auto& shard : m_Shards) {
+    const auto shardStats = shard->getLateness(priority);
+    stats.callbacks += shardStats.callbacks;
+    stats.total += shardStats.total;
+    stats.max = std::max(stats.max, shardStats.max);
+  }
+  return stats;
+}
+
+SchedulerMetrics ShardedScheduler::getMetrics() const {
+  SchedulerMetrics metrics;
+  for (const auto& shard : m_Shards) {
+    metrics += shard->getMetrics();
+  }
+  return metrics;
+}
+
+/**
+ * @brief Maps a key to a shard.
+ * @details Pointers are aligned and keys are often consecutive, a Fibonacci hash spreads both over
+ * the upper bits before the modulo.
+ */
+std::size_t ShardedScheduler::shardOfKey(std::uint64_t key) const {
+  const auto mixed = (key * 0x9E3779B97F4A7C15ULL) >> 32;
+  return static_cast<std::size_t>(mixed % m_Shards.size());
+}
+
+std::size_t ShardedScheduler::placeShard(const IController* controller, const IUserData* userData) {
+  switch (m_Placement) {
+    case Placement::Controller:
+      return shardOfKey(reinterpret_cast<std::uintptr_t>(controller));
+    case Placement::UserData:
+      return shardOfKey(reinterpret_cast<std::uintptr_t>(userData));
+    case Placement::RoundRobin:
+      break;
+  }
+  return m_NextShard.fetch_add(1, std::memory_order_relaxed) % m_Shards.size();
+}
+
+}  // end of namespace tev
@@ -0,0 +1,112 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of the fixed-size block pool.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <new>
+
+#include "slabPool.hpp"
+
+namespace tev {
+
+namespace {
+constexpr std::uint32_t indexOf(std::uint64_t head) {
+  return static_cast<std::uint32_t>(head);
+}
+constexpr std::uint32_t tagOf(std::uint64_t head) {
+  return static_cast<std::uint32_t>(head >> 32);
+}
+}  // namespace
+
+SlabPool::SlabPool(std::size_t blockSize, std::size_t maxBlocks)
+    : m_BlockSize((blockSize + kAlignment - 1) / kAlignment * kAlignment),
+      m_Stride(kHeaderSize + m_BlockSize),
+      m_MaxBlocks(maxBlocks < kMaxBlocks ? maxBlocks : kMaxBlocks) {}
+
+SlabPool::~SlabPool() {
+  for (auto& slab : m_Slabs) {
+    if (auto* memory = slab.load(std::memory_order_relaxed)) {
+      ::operator delete(memory, std::align_val_t{kAlignment});
+    }
+  }
+}
+
+void* SlabPool::allocate() {
+  void* block = tryAllocate();
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  return block;
+}
+
+void* SlabPool::tryAllocate() {
+  Header* block = nullptr;
+  auto head = m_FreeHead.load(std::memory_order_acquire);
+  while (indexOf(head) != kNoBlock) {
+    // chunks are never freed, reading a block popped concurrently is harmless, the tag fails the exchange
+    block = header(indexOf(head));
+    const auto next = block->next.load(std::memory_order_relaxed);
+    if (m_FreeHead.compare_exchange_weak(head, pack(next, tagOf(head) + 1), std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+      break;
+    }
+    block = nullptr;
+  }
+  if (block == nullptr) {
+    const auto index = m_Next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= m_MaxBlocks) {
+      m_Next.fetch_sub(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    ensureChunk(index >> kChunkBits);
+    block = header(index);
+  }
+  m_InUse.fetch_add(1, std::memory_order_relaxed);
+  return reinterpret_cast<std::byte*>(block) + kHeaderSize;
+}
+
+void SlabPool::deallocate(void* memory) noexcept {
+  auto* block = reinterpret_cast<Header*>(static_cast<std::byte*>(memory) - kHeaderSize);
+  auto head = m_FreeHead.load(std::memory_order_relaxed);
+  do {
+    block->next.store(indexOf(head), std::memory_order_relaxed);
+  } while (!m_FreeHead.compare_exchange_weak(head, pack(block->index, tagOf(head) + 1), std::memory_order_release,
+                                             std::memory_order_relaxed));
+  m_InUse.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void SlabPool::reserve(std::size_t blocks) {
+  const auto chunks = (std::min(blocks, m_MaxBlocks) + kChunkBlocks - 1) / kChunkBlocks;
+  for (std::uint32_t chunk = 0; chunk < chunks && chunk < kMaxChunks; ++chunk) {
+    ensureChunk(chunk);
+  }
+}
+
+SlabPool::Header* SlabPool::header(std::uint32_t index) const {
+  auto* slab = m_Slabs[index >> kChunkBits].load(std::memory_order_acquire);
+  return reinterpret_cast<Header*>(slab + static_cast<std::size_t>(index & (kChunkBlocks - 1)) * m_Stride);
+}
+
+void SlabPool::ensureChunk(std::uint32_t chunk) {
+  auto& slab = m_Slabs[chunk];
+  std::byte* memory = slab.load(std::memory_order_acquire);
+  if (memory != nullptr) {
+    return;
+  }
+  // several threads may reach a new chunk at once, the first one installs it
+  auto* fresh = static_cast<std::byte*>(::operator new(m_Stride * kChunkBlocks, std::align_val_t{kAlignment}));
+  for (std::uint32_t i = 0; i < kChunkBlocks; ++i) {
+    new (fresh + i * m_Stride) Header{(chunk << kChunkBits) | i, kNoBlock};
+  }
+  if (slab.compare_exchange_strong(memory, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    m_Chunks.fetch_add(1, std::memory_order_release);
+  } else {
+    ::operator delete(fresh, std::align_val_t{kAlignment});
+  }
+}
+
+}  // end of namespace tev
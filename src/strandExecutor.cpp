@@ -0,0 +1,71 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of serialized execution on the worker pool.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <utility>
+
+#include "strandExecutor.hpp"
+
+namespace tev {
+
+StrandExecutor::~StrandExecutor() {
+  std::unique_lock lock(m_Mutex);
+  m_Drained.wait(lock, [this]() {
+    return m_Strands.empty();
+  });
+}
+
+void StrandExecutor::post(const void* key, Task task) {
+  if (key == nullptr) {
+    m_Pool.submit(std::move(task));
+    return;
+  }
+  bool idle = false;
+  {
+    const std::lock_guard lg(m_Mutex);
+    auto [strand, inserted] = m_Strands.try_emplace(key);
+    strand->second.push_back(std::move(task));
+    idle = inserted;
+  }
+  // a strand which already exists is being drained, the drain picks the task up
+  if (idle) {
+    m_Pool.submit([this, key]() {
+      drain(key);
+    });
+  }
+}
+
+std::size_t StrandExecutor::getActiveStrands() {
+  const std::lock_guard lg(m_Mutex);
+  return m_Strands.size();
+}
+
+void StrandExecutor::drain(const void* key) {
+  for (std::size_t executed = 0; executed < kDrainBatch; ++executed) {
+    Task task;
+    {
+      const std::lock_guard lg(m_Mutex);
+      auto strand = m_Strands.find(key);
+      if (strand->second.empty()) {
+        m_Strands.erase(strand);
+        if (m_Strands.empty()) {
+          m_Drained.notify_all();
+        }
+        return;
+      }
+      task = std::move(strand->second.front());
+      strand->second.pop_front();
+    }
+    task();
+  }
+  // give other strands a chance, the strand stays active and is drained again later
+  m_Pool.submit([this, key]() {
+    drain(key);
+  });
+}
+
+}  // end of namespace tev
@@ -0,0 +1,74 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of the timer file descriptor.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#if defined(__linux__)
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+#include "timerFd.hpp"
+
+namespace tev {
+
+#if defined(__linux__)
+
+namespace {
+void setTime(int fd, std::int64_t sinceEpochNs, int flags) noexcept {
+  itimerspec value{};
+  value.it_value.tv_sec = static_cast<time_t>(sinceEpochNs / 1'000'000'000);
+  value.it_value.tv_nsec = static_cast<long>(sinceEpochNs % 1'000'000'000);
+  (void)timerfd_settime(fd, flags, &value, nullptr);
+}
+}  // namespace
+
+TimerFd::TimerFd() : m_Fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) {
+  if (m_Fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "timerfd_create");
+  }
+}
+
+TimerFd::~TimerFd() {
+  ::close(m_Fd);
+}
+
+void TimerFd::arm(TimePoint deadline) noexcept {
+  // steady_clock is CLOCK_MONOTONIC, a zero it_value would disarm, the epoch start is long past
+  const auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch());
+  setTime(m_Fd, std::max<std::int64_t>(sinceEpoch.count(), 1), TFD_TIMER_ABSTIME);
+}
+
+void TimerFd::armNow() noexcept {
+  setTime(m_Fd, 1, TFD_TIMER_ABSTIME);
+}
+
+void TimerFd::disarm() noexcept {
+  setTime(m_Fd, 0, 0);
+}
+
+void TimerFd::drain() noexcept {
+  std::uint64_t expirations = 0;
+  while (::read(m_Fd, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {
+  }
+}
+
+#else
+
+TimerFd::TimerFd() = default;
+TimerFd::~TimerFd() = default;
+void TimerFd::arm(TimePoint) noexcept {}
+void TimerFd::armNow() noexcept {}
+void TimerFd::disarm() noexcept {}
+void TimerFd::drain() noexcept {}
+
+#endif
+
+}  // end of namespace tev
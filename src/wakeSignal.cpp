@@ -0,0 +1,79 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of the futex based wake-up signal.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <cerrno>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "wakeSignal.hpp"
+
+namespace tev {
+
+#if defined(__linux__)
+
+bool WakeSignal::waitUntil(Token token, TimePoint deadline) {
+  timespec absolute{};
+  const bool limited = deadline != TimePoint::max();
+  if (limited) {
+    const auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch());
+    absolute.tv_sec = static_cast<time_t>(sinceEpoch.count() / 1'000'000'000);
+    absolute.tv_nsec = static_cast<long>(sinceEpoch.count() % 1'000'000'000);
+  }
+  // announce the waiter before the kernel compares the word, notify() either sees it or changed the word before
+  m_Waiters.fetch_add(1, std::memory_order_seq_cst);
+  while (m_Sequence.load(std::memory_order_seq_cst) == token) {
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline, the clock of steady_clock
+    const auto result = ::syscall(SYS_futex, &m_Sequence, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, token,
+                                  limited ? &absolute : nullptr, nullptr, FUTEX_BITSET_MATCH_ANY);
+    if (result < 0 && errno == ETIMEDOUT) {
+      break;
+    }
+  }
+  m_Waiters.fetch_sub(1, std::memory_order_relaxed);
+  return notified(token);
+}
+
+void WakeSignal::notify() noexcept {
+  m_Sequence.fetch_add(1, std::memory_order_seq_cst);
+  if (m_Waiters.load(std::memory_order_seq_cst) != 0) {
+    (void)::syscall(SYS_futex, &m_Sequence, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1, nullptr, nullptr, 0);
+  }
+}
+
+#else
+
+bool WakeSignal::waitUntil(Token token, TimePoint deadline) {
+  std::unique_lock lock(m_Mutex);
+  m_Waiters.fetch_add(1, std::memory_order_seq_cst);
+  auto isNotified = [&]() {
+    return notified(token);
+  };
+  if (deadline == TimePoint::max()) {
+    m_CondVar.wait(lock, isNotified);
+  } else {
+    m_CondVar.wait_until(lock, deadline, isNotified);
+  }
+  m_Waiters.fetch_sub(1, std::memory_order_relaxed);
+  return notified(token);
+}
+
+void WakeSignal::notify() noexcept {
+  {
+    const std::lock_guard lock(m_Mutex);
+    m_Sequence.fetch_add(1, std::memory_order_seq_cst);
+  }
+  m_CondVar.notify_one();
+}
+
+#endif
+
+}  // end of namespace tev
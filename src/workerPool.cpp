@@ -0,0 +1,113 @@
+/*************************************************************************/ /**
+ * \file
+ * \brief  contains class implementations of the callback worker pool.
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <utility>
+
+#include "workerPool.hpp"
+
+namespace tev {
+
+namespace {
+/// Pool and worker index of the calling thread, if it is a pool worker
+thread_local const WorkerPool* tlsPool{nullptr};
+thread_local std::size_t tlsWorker{0};
+}  // namespace
+
+WorkerPool::WorkerPool(std::size_t threadCount) {
+  const auto count = std::max<std::size_t>(threadCount, 1);
+  m_Workers.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    m_Workers.push_back(std::make_unique<Worker>());
+  }
+  // start the threads only when all deques exist, workers steal from each other
+  for (std::size_t i = 0; i < count; ++i) {
+    m_Workers[i]->thread = std::jthread([this, i]() {
+      run(i);
+    });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    const std::lock_guard lg(m_IdleMutex);
+    m_Stop = true;
+  }
+  m_IdleEvent.notify_all();
+  for (auto& worker : m_Workers) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+bool WorkerPool::isWorkerThread() const {
+  return tlsPool == this;
+}
+
+void WorkerPool::submit(Task task) {
+  const auto target =
+      isWorkerThread() ? tlsWorker : m_NextWorker.fetch_add(1, std::memory_order_relaxed) % m_Workers.size();
+  {
+    auto& worker = *m_Workers[target];
+    const std::lock_guard lg(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+  }
+  m_Pending.fetch_add(1, std::memory_order_release);
+  {
+    // pairs with the predicate check of the sleeping workers
+    const std::lock_guard lg(m_IdleMutex);
+  }
+  m_IdleEvent.notify_one();
+}
+
+bool WorkerPool::tryPop(std::size_t self, Task& task) {
+  {
+    auto& own = *m_Workers[self];
+    const std::lock_guard lg(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.front());
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+  // steal from the back of the other deques
+  for (std::size_t i = 1; i < m_Workers.size(); ++i) {
+    auto& victim = *m_Workers[(self + i) % m_Workers.size()];
+    const std::lock_guard lg(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkerPool::run(std::size_t self) {
+  tlsPool = this;
+  tlsWorker = self;
+  while (true) {
+    Task task;
+    if (tryPop(self, task)) {
+      m_Pending.fetch_sub(1, std::memory_order_acq_rel);
+      task();
+      continue;
+    }
+    std::unique_lock lock(m_IdleMutex);
+    m_IdleEvent.wait(lock, [this]() {
+      return m_Stop || m_Pending.load(std::memory_order_acquire) > 0;
+    });
+    if (m_Stop && m_Pending.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+  }
+  tlsPool = nullptr;
+}
+
+}  // end of namespace tev
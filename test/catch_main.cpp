@@ -1,6 +1,12 @@
+#if __has_include(<catch2/catch_all.hpp>)
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_all.hpp>
+#else
+// Catch2 v2 provides the session only with a custom runner
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+#endif
 
 int main(int argc, char** argv) {
   return Catch::Session().run(argc, argv);
-}
\ No newline at end of file
+}
@@ -1,9 +1,1865 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#if defined(__linux__)
+#include <poll.h>
+#endif
 
+#if __has_include(<catch2/catch_all.hpp>)
 #include <catch2/catch_all.hpp>
+#else
+#include <catch2/catch.hpp>
+#endif
 
+#include "eventHandleTable.hpp"
+#include "eventHeap.hpp"
+#include "eventTracer.hpp"
+#include "inplaceFunction.hpp"
+#include "ioUringWaiter.hpp"
+#include "latencyHistogram.hpp"
+#include "mpscQueue.hpp"
 #include "scheduler.hpp"
+#include "schedulerMetrics.hpp"
+#include "shardedScheduler.hpp"
+#include "slabPool.hpp"
+#include "strandExecutor.hpp"
+#include "timingWheel.hpp"
+#include "workerPool.hpp"
+
+using namespace tev;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct TestController : public IController {};
+struct TestUserData : public IUserData {};
+
+/// Counts the invocations of every lifecycle callback.
+struct CallbackCounters {
+  std::atomic<int> started{0};
+  std::atomic<int> served{0};
+  std::atomic<int> aborted{0};
+  std::atomic<int> completed{0};
+  std::atomic<int> timedOut{0};
+};
+
+EventConfig makeConfig(CallbackCounters& counters, DurationUnit delay, DurationUnit serve, DurationUnit life) {
+  return EventConfig{delay,
+                     serve,
+                     life,
+                     [&counters](EventPtr) {
+                       ++counters.started;
+                     },
+                     [&counters](EventPtr) {
+                       ++counters.served;
+                     },
+                     [&counters](EventPtr) {
+                       ++counters.aborted;
+                     },
+                     [&counters](EventPtr) {
+                       ++counters.completed;
+                     },
+                     [&counters](EventPtr) {
+                       ++counters.timedOut;
+                     }};
+}
+
+/// Drives the scheduler manually until the condition holds or the limit is reached.
+template <class TDone>
+void runUntil(Scheduler& scheduler, TDone&& done, DurationUnit limit) {
+  const auto until = std::chrono::steady_clock::now() + limit;
+  while (std::chrono::steady_clock::now() < until) {
+    auto wait = scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    if (done()) {
+      break;
+    }
+    const auto left = until - std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(wait, left));
+  }
+}
+
+/// Drives the scheduler manually until all events are gone or the limit is reached.
+void runUntilEmpty(Scheduler& scheduler, DurationUnit limit) {
+  runUntil(
+      scheduler,
+      [&]() {
+        return scheduler.getEventsCount() == 0;
+      },
+      limit);
+}
+
+}  // namespace
 
 TEST_CASE("Simple Task Runs", "[task]") {
   CHECK_FALSE(false);
-}
\ No newline at end of file
+}
+
+TEST_CASE("EventHeap keeps the earliest deadline on top", "[heap]") {
+  EventHeap heap;
+  std::vector<EventPtr> events;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> dist(0, 10000);
+  const auto base = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < 200; ++i) {
+    events.push_back(std::make_shared<Event>());
+    heap.push(events.back(), base + std::chrono::milliseconds(dist(rng)));
+  }
+  REQUIRE(heap.size() == events.size());
+
+  SECTION("pop returns deadlines in order") {
+    auto last = heap.top().deadline;
+    while (!heap.empty()) {
+      CHECK(heap.top().deadline >= last);
+      last = heap.top().deadline;
+      auto event = heap.pop();
+      CHECK(event->getQueueIndex() == Event::kNotQueued);
+    }
+  }
+
+  SECTION("erase and update keep positions consistent") {
+    for (std::size_t i = 0; i < events.size(); i += 3) {
+      CHECK(heap.erase(*events[i]) == events[i]);
+      CHECK_FALSE(heap.contains(*events[i]));
+    }
+    CHECK(heap.erase(*events[0]) == nullptr);
+    CHECK(heap.update(*events[1], base - 1ms));
+    CHECK(heap.top().event == events[1]);
+
+    auto removed = heap.eraseIf([&](const EventPtr& event) {
+      return event == events[2];
+    });
+    CHECK(removed == 1);
+    for (const auto& entry : heap) {
+      CHECK(heap.contains(*entry.event));
+    }
+    auto last = heap.top().deadline;
+    while (!heap.empty()) {
+      CHECK(heap.top().deadline >= last);
+      last = heap.top().deadline;
+      heap.pop();
+    }
+  }
+}
+
+TEST_CASE("TimingWheel expires events never early and at most one tick late", "[wheel]") {
+  const auto base = std::chrono::steady_clock::now();
+  TimingWheel wheel(1ms, base);
+  std::vector<EventPtr> events;
+  std::vector<std::chrono::steady_clock::time_point> deadlines;
+  std::mt19937 rng(7);
+  // spread over all wheel levels: up to ~20 minutes
+  std::uniform_int_distribution<int> dist(0, 1200000);
+
+  for (int i = 0; i < 2000; ++i) {
+    events.push_back(std::make_shared<Event>());
+    deadlines.push_back(base + std::chrono::microseconds(dist(rng) * 1000 + dist(rng) % 1000));
+    wheel.push(events.back(), deadlines.back());
+  }
+  // cancel every fifth event
+  for (std::size_t i = 0; i < events.size(); i += 5) {
+    CHECK(wheel.erase(*events[i]) == events[i]);
+    CHECK_FALSE(wheel.contains(*events[i]));
+  }
+  CHECK(wheel.size() == events.size() - events.size() / 5);
+
+  std::size_t expired = 0;
+  std::vector<EventPtr> due;
+  auto now = base;
+  while (!wheel.empty()) {
+    auto earliest = wheel.earliestDeadline();
+    REQUIRE(earliest.has_value());
+    REQUIRE(*earliest > now - 1ms);
+    now = std::max(now + 1ms, *earliest);
+    due.clear();
+    wheel.popDue(now, due);
+    for (const auto& event : due) {
+      const auto index = static_cast<std::size_t>(
+          std::find(events.begin(), events.end(), event) - events.begin());
+      CHECK(index % 5 != 0);
+      CHECK(deadlines[index] <= now);
+      CHECK(now - deadlines[index] <= 2ms);
+      CHECK_FALSE(wheel.contains(*event));
+    }
+    expired += due.size();
+  }
+  CHECK(expired == events.size() - events.size() / 5);
+}
+
+TEST_CASE("MpscQueue keeps the order of every producer", "[mpsc]") {
+  constexpr int kProducers = 4;
+  constexpr int kPerProducer = 10000;
+  MpscQueue<std::pair<int, int>> queue;
+  std::vector<std::jthread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&queue, p]() {
+      for (int i = 0; i < kPerProducer; ++i) {
+        queue.push({p, i});
+      }
+    });
+  }
+  std::array<int, kProducers> next{};
+  int received = 0;
+  bool ordered = true;
+  const auto until = std::chrono::steady_clock::now() + 10s;
+  while (received < kProducers * kPerProducer && std::chrono::steady_clock::now() < until) {
+    std::pair<int, int> item;
+    if (!queue.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    auto& expected = next[static_cast<std::size_t>(item.first)];
+    ordered = ordered && item.second == expected;
+    expected = item.second + 1;
+    ++received;
+  }
+  CHECK(received == kProducers * kPerProducer);
+  CHECK(ordered);
+  std::pair<int, int> item;
+  CHECK_FALSE(queue.pop(item));
+}
+
+TEST_CASE("MpscQueue allocates beyond its pooled nodes", "[mpsc][slab]") {
+  SlabPool limited(16, SlabPool::kChunkBlocks);
+  CHECK(limited.getMaxBlocks() == SlabPool::kChunkBlocks);
+  std::vector<void*> blocks;
+  while (void* block = limited.tryAllocate()) {
+    blocks.push_back(block);
+  }
+  CHECK(blocks.size() == SlabPool::kChunkBlocks);
+  CHECK_THROWS_AS((void)limited.allocate(), std::bad_alloc);
+  limited.deallocate(blocks.back());
+  CHECK(limited.tryAllocate() == blocks.back());
+
+  // values past the pooled nodes are allocated with new and keep their order
+  MpscQueue<int> queue(SlabPool::kChunkBlocks);
+  constexpr int kValues = 3 * static_cast<int>(SlabPool::kChunkBlocks);
+  for (int i = 0; i < kValues; ++i) {
+    queue.push(i);
+  }
+  {
+    MpscQueue<int>::Batch batch(queue);
+    batch.add(kValues);
+    queue.push(batch);
+  }
+  int value = -1;
+  bool ordered = true;
+  for (int i = 0; i <= kValues; ++i) {
+    ordered = queue.pop(value) && value == i && ordered;
+  }
+  CHECK(ordered);
+  CHECK_FALSE(queue.pop(value));
+}
+
+TEST_CASE("MpscQueue appends batches without interleaving", "[mpsc]") {
+  constexpr int kProducers = 4;
+  constexpr int kBatches = 1000;
+  constexpr int kBatchSize = 10;
+  MpscQueue<std::pair<int, int>> queue;
+  // Catch assertions are not thread-safe, the producers only record
+  std::atomic<bool> emptied{true};
+  std::vector<std::jthread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&queue, &emptied, p]() {
+      for (int b = 0; b < kBatches; ++b) {
+        MpscQueue<std::pair<int, int>>::Batch batch(queue);
+        for (int i = 0; i < kBatchSize; ++i) {
+          batch.add({p, b * kBatchSize + i});
+        }
+        queue.push(batch);
+        if (!batch.empty()) {
+          emptied = false;
+        }
+      }
+      // a batch which is never pushed releases its values
+      MpscQueue<std::pair<int, int>>::Batch dropped(queue);
+      dropped.add({p, -1});
+    });
+  }
+  int received = 0;
+  bool contiguous = true;
+  std::pair<int, int> previous{-1, -1};
+  const auto until = std::chrono::steady_clock::now() + 10s;
+  while (received < kProducers * kBatches * kBatchSize && std::chrono::steady_clock::now() < until) {
+    std::pair<int, int> item;
+    if (!queue.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    // inside a batch the next value follows from the same producer
+    if (item.second % kBatchSize != 0) {
+      contiguous = contiguous && item.first == previous.first && item.second == previous.second + 1;
+    }
+    previous = item;
+    ++received;
+  }
+  producers.clear();
+  CHECK(emptied);
+  CHECK(received == kProducers * kBatches * kBatchSize);
+  CHECK(contiguous);
+  std::pair<int, int> item;
+  CHECK_FALSE(queue.pop(item));
+}
+
+TEST_CASE("Scheduler accepts pushes and erases from many threads", "[scheduler][mpsc]") {
+  constexpr std::size_t kProducers = 8;
+  constexpr std::size_t kPerProducer = 200;
+  Scheduler scheduler;
+  CallbackCounters counters;
+  auto controller = std::make_shared<TestController>();
+  REQUIRE(scheduler.start());
+  {
+    std::vector<std::jthread> producers;
+    for (std::size_t p = 0; p < kProducers; ++p) {
+      producers.emplace_back([&]() {
+        auto userData = std::make_shared<TestUserData>();
+        for (std::size_t i = 0; i < kPerProducer; ++i) {
+          auto event = scheduler.pushEvent(controller, userData, makeConfig(counters, 0ms, 10s, 60s));
+          if (i % 2 == 1) {
+            scheduler.eraseEvent(event);
+          }
+        }
+      });
+    }
+  }
+  // pushes not applied yet are counted as well
+  CHECK(scheduler.getEventsCount() >= kProducers * kPerProducer / 2);
+  const auto until = std::chrono::steady_clock::now() + 2s;
+  while (scheduler.getEventsCount() != kProducers * kPerProducer / 2 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  scheduler.terminate();
+  CHECK(scheduler.getEventsCount() == kProducers * kPerProducer / 2);
+}
+
+TEST_CASE("Scheduler pushes and erases batches with one wake-up", "[scheduler][batch]") {
+  constexpr std::size_t kEvents = 1000;
+  Scheduler scheduler;
+  CallbackCounters counters;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+  REQUIRE(scheduler.start());
+
+  const std::vector configs(kEvents, makeConfig(counters, 0ms, 10s, 60s));
+  const auto wakeRequests = scheduler.getMetrics().pushWakeRequests;
+  const auto events = scheduler.pushEvents(controller, userData, configs);
+  REQUIRE(events.size() == kEvents);
+  auto until = std::chrono::steady_clock::now() + 2s;
+  while (counters.started != static_cast<int>(kEvents) && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  CHECK(counters.started == static_cast<int>(kEvents));
+  CHECK(scheduler.getMetrics().pushWakeRequests - wakeRequests == 1);
+  CHECK(std::all_of(events.begin(), events.end(), [&](const EventPtr& event) {
+    return scheduler.owns(*event);
+  }));
+
+  std::vector<EventPtr> erased(events.begin(), events.begin() + kEvents / 2);
+  erased.push_back(nullptr);
+  scheduler.eraseEvents(erased);
+  // erases wait for the next pass
+  scheduler.wakeUp();
+  until = std::chrono::steady_clock::now() + 2s;
+  while (scheduler.getEventsCount() != kEvents / 2 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  scheduler.terminate();
+  CHECK(scheduler.getEventsCount() == kEvents / 2);
+  CHECK(scheduler.getMetrics().erases == kEvents / 2);
+  CHECK(scheduler.getMetrics().pushWakeRequests - wakeRequests == 1);
+
+  // erased events are pushed again, the nullptr is skipped
+  CHECK(scheduler.pushEvents(erased) == kEvents / 2);
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+  CHECK(scheduler.getEventsCount() == kEvents);
+}
+
+TEST_CASE("Scheduler serves due events", "[scheduler]") {
+  auto queueMode = GENERATE(Scheduler::QueueMode::Heap, Scheduler::QueueMode::TimingWheel);
+  Scheduler scheduler(queueMode);
+  CallbackCounters counters;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+
+  SECTION("start, serve and timeout") {
+    auto event = scheduler.pushEvent(controller, userData, makeConfig(counters, 0ms, 20ms, 110ms));
+    REQUIRE(scheduler.getEventsCount() == 1);
+
+    // the timing wheel rounds deadlines up to the next tick
+    runUntil(
+        scheduler,
+        [&]() {
+          return counters.started == 1;
+        },
+        50ms);
+    CHECK(counters.started == 1);
+    CHECK(counters.served == 0);
+    CHECK(scheduler.processEvents(Scheduler::kMaxDelayIntervalMs) <= 21ms);
+
+    runUntilEmpty(scheduler, 500ms);
+    CHECK(scheduler.getEventsCount() == 0);
+    CHECK(counters.served >= 3);
+    CHECK(counters.timedOut == 1);
+  }
+
+  SECTION("start delay postpones the start callback") {
+    auto event = scheduler.pushEvent(controller, userData, makeConfig(counters, 50ms, 20ms, 1000ms));
+    auto wait = scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(counters.started == 0);
+    CHECK(wait > 20ms);
+    // the timing wheel reports the deadline rounded up to its tick
+    CHECK(wait <= 51ms);
+  }
+
+  SECTION("a pass does not touch events which are not due") {
+    for (int i = 0; i < 100; ++i) {
+      auto event = scheduler.pushEvent(controller, userData, makeConfig(counters, 0ms, 10s, 60s));
+    }
+    runUntil(
+        scheduler,
+        [&]() {
+          return counters.started == 100;
+        },
+        50ms);
+    CHECK(counters.started == 100);
+    auto wait = scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(counters.started == 100);
+    CHECK(counters.served == 0);
+    CHECK(wait == Scheduler::kMaxDelayIntervalMs);
+  }
+
+  SECTION("final states invoke their callbacks once") {
+    auto completeConfig = makeConfig(counters, 0ms, 10ms, 60s);
+    completeConfig.eventCallback = [](EventPtr e) {
+      e->setStatus(Event::Status::Completed);
+    };
+    auto abortConfig = makeConfig(counters, 0ms, 10ms, 60s);
+    abortConfig.eventCallback = [](EventPtr e) {
+      e->setStatus(Event::Status::Aborted);
+    };
+    auto completed = scheduler.pushEvent(controller, userData, completeConfig);
+    auto aborted = scheduler.pushEvent(controller, userData, abortConfig);
+
+    runUntilEmpty(scheduler, 500ms);
+    CHECK(counters.completed == 1);
+    CHECK(counters.aborted == 1);
+    CHECK(scheduler.getEventsCount() == 0);
+  }
+
+  SECTION("erase by event and by user data") {
+    auto other = std::make_shared<TestUserData>();
+    auto first = scheduler.pushEvent(controller, userData, makeConfig(counters, 0ms, 10ms, 60s));
+    auto second = scheduler.pushEvent(controller, other, makeConfig(counters, 0ms, 10ms, 60s));
+    auto third = scheduler.pushEvent(controller, other, makeConfig(counters, 0ms, 10ms, 60s));
+    CHECK(scheduler.getEventsCount() == 3);
+    // erases are applied by the next pass
+    scheduler.eraseEvent(first);
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 2);
+    scheduler.eraseEvent(std::shared_ptr<IUserData>(other));
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 0);
+  }
+}
+
+TEST_CASE("InplaceFunction stores callables inline", "[callback]") {
+  STATIC_REQUIRE(sizeof(ControllerEventCallback) == TEV_CALLBACK_BUFFER_SIZE + sizeof(void*));
+
+  /// Counts the live copies of a capture
+  struct Tracked {
+    explicit Tracked(int& alive) : alive(&alive) {
+      ++*this->alive;
+    }
+    Tracked(const Tracked& other) : alive(other.alive) {
+      ++*alive;
+    }
+    Tracked(Tracked&& other) noexcept : alive(other.alive) {
+      ++*alive;
+    }
+    Tracked& operator=(const Tracked&) = delete;
+    ~Tracked() {
+      --*alive;
+    }
+    int* alive;
+  };
+
+  int alive = 0;
+  int calls = 0;
+  {
+    InplaceFunction<int(int), 16> empty = nullptr;
+    CHECK_FALSE(empty);
+    CHECK(empty == nullptr);
+
+    InplaceFunction<int(int), 16> function = [tracked = Tracked(alive), &calls](int value) {
+      ++calls;
+      return value * 2;
+    };
+    CHECK(alive == 1);
+    CHECK(function(21) == 42);
+
+    auto copy = function;
+    CHECK(alive == 2);
+    auto moved = std::move(function);
+    CHECK(alive == 2);
+    CHECK_FALSE(function);
+    CHECK(moved(1) + copy(2) == 6);
+    CHECK(calls == 3);
+
+    copy = nullptr;
+    CHECK(alive == 1);
+    empty = moved;
+    CHECK(alive == 2);
+  }
+  CHECK(alive == 0);
+
+  // the default buffer takes the captures of a typical callback, e.g. a few pointers and a shared_ptr
+  auto owner = std::make_shared<int>(4);
+  int* first = &alive;
+  int* second = &calls;
+  ControllerEventCallback callback = [owner, first, second, &alive](const EventPtr&) {
+    *first = *owner;
+    *second = *owner + alive;
+  };
+  callback(nullptr);
+  CHECK(alive == 4);
+  CHECK(calls == 8);
+}
+
+TEST_CASE("SlabPool recycles blocks", "[slab]") {
+  SlabPool pool(40);
+  CHECK(pool.getBlockSize() == 48);
+  CHECK(pool.getCapacity() == 0);
+  pool.reserve(SlabPool::kChunkBlocks + 1);
+  CHECK(pool.getCapacity() == 2 * SlabPool::kChunkBlocks);
+
+  void* first = pool.allocate();
+  void* second = pool.allocate();
+  CHECK(first != second);
+  CHECK(reinterpret_cast<std::uintptr_t>(first) % SlabPool::kAlignment == 0);
+  CHECK(pool.getInUse() == 2);
+  pool.deallocate(first);
+  CHECK(pool.allocate() == first);
+  pool.deallocate(first);
+  pool.deallocate(second);
+  CHECK(pool.getInUse() == 0);
+
+  // blocks move between threads without loss or duplicates
+  std::vector<std::jthread> threads;
+  std::array<std::vector<void*>, 4> taken;
+  for (std::size_t t = 0; t < taken.size(); ++t) {
+    threads.emplace_back([&pool, &block = taken[t]]() {
+      for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 50; ++i) {
+          block.push_back(pool.allocate());
+        }
+        for (int i = 0; i < 25; ++i) {
+          pool.deallocate(block.back());
+          block.pop_back();
+        }
+      }
+    });
+  }
+  threads.clear();
+  std::unordered_set<void*> unique;
+  for (const auto& blocks : taken) {
+    unique.insert(blocks.begin(), blocks.end());
+  }
+  CHECK(unique.size() == 4 * 100 * 25);
+  CHECK(pool.getInUse() == unique.size());
+}
+
+TEST_CASE("Scheduler slab storage keeps events in the pool", "[scheduler][slab]") {
+  CHECK(Scheduler().getEventPool() == nullptr);
+  Scheduler::Config config;
+  config.eventStorage = Scheduler::EventStorage::Slab;
+  CallbackCounters counters;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+  std::weak_ptr<SlabPool> pool;
+  EventPtr kept;
+  {
+    Scheduler scheduler(config);
+    REQUIRE(scheduler.getEventPool());
+    pool = scheduler.getEventPool();
+    scheduler.reserve(100);
+    CHECK(pool.lock()->getCapacity() >= 100);
+
+    (void)scheduler.pushEvent(controller, userData, makeConfig(counters, 0ms, 1ms, 20ms));
+    CHECK(pool.lock()->getInUse() == 1);
+    runUntilEmpty(scheduler, 500ms);
+    CHECK(counters.timedOut == 1);
+    CHECK(pool.lock()->getInUse() == 0);
+    kept = scheduler.pushEvent(controller, userData, makeConfig(counters, 0ms, 1ms, 20ms));
+    CHECK(pool.lock()->getInUse() == 1);
+  }
+  // an event may outlive its scheduler, it keeps the pool alive
+  REQUIRE_FALSE(pool.expired());
+  kept.reset();
+  CHECK(pool.expired());
+}
+
+TEST_CASE("EventHandleTable detects stale handles", "[handle]") {
+  EventHandleTable table;
+  Event event;
+  auto first = table.acquire(&event);
+  REQUIRE(first.valid());
+  CHECK(table.isLive(first));
+  CHECK(table.get(first) == &event);
+  table.setStatus(first, Event::Status::Running);
+  CHECK(table.getStatus(first) == Event::Status::Running);
+
+  CHECK(table.release(first));
+  CHECK_FALSE(table.release(first));
+  CHECK_FALSE(table.isLive(first));
+  CHECK(table.get(first) == nullptr);
+  CHECK_FALSE(table.getStatus(first).has_value());
+
+  // the slot is recycled with the next generation
+  auto second = table.acquire(&event);
+  CHECK(second.slot == first.slot);
+  CHECK(second.generation == first.generation + 1);
+  CHECK_FALSE(table.isLive(first));
+  CHECK(table.isLive(second));
+  CHECK_FALSE(table.isLive(EventHandle{}));
+  CHECK(table.getCapacity() == 1);
+
+  // the tag tells the tables apart, a table ignores the handles of another one
+  EventHandleTable tagged(EventHandleTable::kMaxTag);
+  const auto foreign = tagged.acquire(&event);
+  CHECK(EventHandleTable::tagOfHandle(foreign) == EventHandleTable::kMaxTag);
+  CHECK(EventHandleTable::tagOfHandle(second) == 0);
+  CHECK(tagged.get(foreign) == &event);
+  CHECK(table.get(foreign) == nullptr);
+  CHECK_FALSE(tagged.release(second));
+  CHECK(tagged.release(foreign));
+  CHECK_THROWS_AS(EventHandleTable(EventHandleTable::kMaxTag + 1), std::invalid_argument);
+}
+
+TEST_CASE("Scheduler cancels and queries events by handle", "[scheduler][handle]") {
+  auto queueMode = GENERATE(Scheduler::QueueMode::Heap, Scheduler::QueueMode::TimingWheel);
+  Scheduler scheduler(queueMode);
+  CallbackCounters counters;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+
+  std::vector<EventHandle> handles;
+  for (int i = 0; i < 100; ++i) {
+    auto event = std::make_shared<Event>(controller, userData, makeConfig(counters, 0ms, 10s, 60s));
+    handles.push_back(scheduler.pushEvent(event));
+    CHECK(event->getHandle() == handles.back());
+  }
+  CHECK(scheduler.getEventStatus(handles[0]) == Event::Status::Pending);
+  runUntil(
+      scheduler,
+      [&]() {
+        return counters.started == 100;
+      },
+      50ms);
+  CHECK(scheduler.getEventStatus(handles[0]) == Event::Status::Running);
+
+  // cancel every other event, a second cancel of the same handle is ignored
+  for (std::size_t i = 0; i < handles.size(); i += 2) {
+    CHECK(scheduler.cancelEvent(handles[i]));
+  }
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+  CHECK(scheduler.getEventsCount() == 50);
+  CHECK_FALSE(scheduler.cancelEvent(handles[0]));
+  CHECK_FALSE(scheduler.getEventStatus(handles[0]).has_value());
+  CHECK(scheduler.getEventStatus(handles[1]).has_value());
+
+  // a finished event turns its handle stale
+  auto config = makeConfig(counters, 0ms, 1ms, 60s);
+  config.eventCallback = [](EventPtr e) {
+    e->setStatus(Event::Status::Completed);
+  };
+  auto finished = scheduler.pushEvent(std::make_shared<Event>(controller, userData, config));
+  runUntil(
+      scheduler,
+      [&]() {
+        return counters.completed == 1;
+      },
+      500ms);
+  CHECK(counters.completed == 1);
+  CHECK_FALSE(scheduler.getEventStatus(finished).has_value());
+  CHECK_FALSE(scheduler.cancelEvent(finished));
+  CHECK(scheduler.getEventsCount() == 50);
+}
+
+TEST_CASE("Scheduler hands every push a handle of its own", "[scheduler][handle]") {
+  Scheduler scheduler;
+  CallbackCounters counters;
+  auto event = std::make_shared<Event>(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                                       makeConfig(counters, 0ms, 10s, 60s));
+
+  SECTION("push, erase and push again before a pass, the last handle cancels") {
+    const auto first = scheduler.pushEvent(event);
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    scheduler.eraseEvent(event);
+    const auto second = scheduler.pushEvent(event);
+    CHECK(second != first);
+    CHECK(scheduler.getEventStatus(second).has_value());
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 1);
+    CHECK_FALSE(scheduler.getEventStatus(first).has_value());
+    CHECK(event->getHandle() == second);
+    CHECK(scheduler.cancelEvent(second));
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 0);
+    CHECK_FALSE(scheduler.owns(*event));
+  }
+  SECTION("concurrent pushes of one event, the last applied one wins and no slot leaks") {
+    constexpr int kPushes = 500;
+    std::vector<EventHandle> handles(2 * kPushes);
+    {
+      std::vector<std::jthread> producers;
+      for (int p = 0; p < 2; ++p) {
+        producers.emplace_back([&, p]() {
+          for (int i = 0; i < kPushes; ++i) {
+            handles[static_cast<std::size_t>(p * kPushes + i)] = scheduler.pushEvent(event);
+          }
+        });
+      }
+    }
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 1);
+    CHECK(scheduler.owns(*event));
+    const auto live = std::count_if(handles.begin(), handles.end(), [&](const EventHandle& handle) {
+      return scheduler.getEventStatus(handle).has_value();
+    });
+    CHECK(live == 1);
+  }
+}
+
+TEST_CASE("Typed event configs hand over concrete types", "[scheduler][typed]") {
+  struct CountingController : public IController {
+    int started{0};
+    int served{0};
+  };
+  struct NamedUserData : public IUserData {
+    int timeouts{0};
+  };
+
+  Scheduler scheduler;
+  auto controller = std::make_shared<CountingController>();
+  auto userData = std::make_shared<NamedUserData>();
+  const TypedEventConfig<CountingController, NamedUserData> typedConfig{
+      0ms,
+      1ms,
+      20ms,
+      [](const EventPtr&, CountingController& c, NamedUserData&) {
+        ++c.started;
+      },
+      [](const EventPtr&, CountingController& c, NamedUserData&) {
+        ++c.served;
+      },
+      nullptr,
+      nullptr,
+      [](const EventPtr& e, CountingController&, NamedUserData& data) {
+        CHECK(e->getStatus() == Event::Status::Timeouted);
+        ++data.timeouts;
+      }};
+  CHECK_FALSE(typedConfig.getConfig().abortCallback);
+
+  // typed and type-erased events share the scheduler
+  CallbackCounters counters;
+  auto typed = scheduler.pushEvent(controller, userData, typedConfig);
+  auto erased = scheduler.pushEvent(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                                    makeConfig(counters, 0ms, 1ms, 20ms));
+  CHECK(typed->getController() == controller);
+  runUntilEmpty(scheduler, 500ms);
+  CHECK(controller->started == 1);
+  CHECK(controller->served >= 1);
+  CHECK(userData->timeouts == 1);
+  CHECK(counters.timedOut == 1);
+}
+
+TEST_CASE("Periodic events keep their phase and report missed periods", "[scheduler][period]") {
+  const auto policy = GENERATE(CatchUpPolicy::Skip, CatchUpPolicy::FireOnceAndRealign, CatchUpPolicy::Burst);
+  constexpr DurationUnit kPeriod{10ms};
+
+  /// Start points of the served periods relative to the start deadline
+  struct Trace {
+    Event::EventClock::TimePoint anchor{};
+    std::vector<Event::EventClock::TimePoint::duration> offsets;
+  } trace;
+  auto onStart = [&trace](const EventPtr& e) {
+    trace.anchor = e->getEventClock().StartPoint();
+  };
+  auto onServe = [&trace](const EventPtr& e) {
+    trace.offsets.push_back(e->getEventClock().StartPoint() - trace.anchor);
+    if (trace.offsets.size() == 1) {
+      // overrun the following periods
+      std::this_thread::sleep_for(45ms);
+    }
+  };
+
+  Scheduler scheduler;
+  auto event = scheduler.pushEvent(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                                   EventConfig{0ms, kPeriod, Event::kDefaultEndlessLifeMs, onStart, onServe, nullptr,
+                                               nullptr, nullptr, policy});
+  runUntil(
+      scheduler,
+      [&]() {
+        return trace.offsets.size() >= 8;
+      },
+      1s);
+  REQUIRE(trace.offsets.size() >= 8);
+  CHECK(scheduler.getMissedPeriods() == event->getMissedPeriods());
+
+  switch (policy) {
+    case CatchUpPolicy::Skip:
+      // the late period is served, the periods overrun after it are dropped and the grid is kept
+      CHECK(event->getMissedPeriods() >= 3);
+      CHECK(trace.offsets[1] - trace.offsets[0] >= 4 * kPeriod);
+      for (const auto& offset : trace.offsets) {
+        CHECK(offset % kPeriod == DurationUnit::zero());
+      }
+      break;
+    case CatchUpPolicy::FireOnceAndRealign:
+      CHECK(event->getMissedPeriods() >= 3);
+      break;
+    case CatchUpPolicy::Burst:
+      // every period is served, late ones back to back
+      CHECK(event->getMissedPeriods() == 0);
+      for (std::size_t i = 0; i < trace.offsets.size(); ++i) {
+        CHECK(trace.offsets[i] == static_cast<long>(i + 1) * kPeriod);
+      }
+      break;
+  }
+  scheduler.eraseEvent(event);
+  runUntilEmpty(scheduler, 500ms);
+}
+
+TEST_CASE("Scheduler serves sub-millisecond periods with every wait strategy", "[scheduler][wait]") {
+  using WaitStrategy = Scheduler::WaitStrategy;
+  const auto strategy = GENERATE(WaitStrategy::Sleep, WaitStrategy::SleepUntil, WaitStrategy::SleepThenSpin,
+                                 WaitStrategy::BusyPoll, WaitStrategy::IoUring);
+  CallbackCounters counters;
+  Scheduler::Config config;
+  config.waitStrategy = strategy;
+  Scheduler scheduler(config);
+  // a pass on the empty scheduler must not sleep for the maximum interval in SleepUntil
+  scheduler.setMaxInterval(1ms);
+
+  auto event = scheduler.pushEvent(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                                   makeConfig(counters, 0ms, 200us, Event::kDefaultEndlessLifeMs));
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+  REQUIRE(counters.started == 1);
+  // the wait is not rounded up to whole milliseconds
+  const auto wait = scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+  CHECK(wait <= 200us);
+
+  REQUIRE(scheduler.start());
+  const auto until = std::chrono::steady_clock::now() + 2s;
+  while (counters.served < 20 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  scheduler.terminate();
+  scheduler.eraseEvent(event);
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+  CHECK(counters.served >= 20);
+}
+
+TEST_CASE("Scheduler wakes only for pushes due before its sleep deadline", "[scheduler][wake]") {
+  CallbackCounters counters;
+  Scheduler scheduler;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+  auto waitForPasses = [&]() {
+    // settles once no wake-up is pending
+    auto passes = scheduler.getPassCount();
+    for (std::this_thread::sleep_for(20ms); passes != scheduler.getPassCount(); std::this_thread::sleep_for(20ms)) {
+      passes = scheduler.getPassCount();
+    }
+    return passes;
+  };
+
+  auto first = scheduler.pushEvent(controller, userData, makeConfig(counters, 10s, 1s, 20s));
+  REQUIRE(scheduler.start());
+  const auto passes = waitForPasses();
+
+  // later events and erases wait for the pass at the sleep deadline
+  for (int i = 0; i < 1000; ++i) {
+    (void)scheduler.pushEvent(controller, userData, makeConfig(counters, 20s, 1s, 30s));
+  }
+  scheduler.eraseEvent(first);
+  std::this_thread::sleep_for(50ms);
+  CHECK(scheduler.getPassCount() == passes);
+  CHECK(scheduler.getEventsCount() == 1001);
+
+  // an earlier event wakes the scheduler
+  (void)scheduler.pushEvent(controller, std::make_shared<TestUserData>(), makeConfig(counters, 0ms, 1s, 1s));
+  const auto until = std::chrono::steady_clock::now() + 2s;
+  while (counters.started == 0 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  CHECK(counters.started == 1);
+  CHECK(scheduler.getPassCount() > passes);
+  // the pass applied the erase as well, the count is published once the pass is over
+  (void)waitForPasses();
+  CHECK(scheduler.getEventsCount() == 1001);
+  scheduler.terminate();
+}
+
+TEST_CASE("Scheduler coalesces deadlines within the event slack", "[scheduler][slack]") {
+  /// Runs 50 events with slightly different periods for 200 ms
+  auto run = [](DurationUnit slack, std::uint64_t& passes, bool& early) {
+    Scheduler scheduler;
+    auto controller = std::make_shared<TestController>();
+    auto userData = std::make_shared<TestUserData>();
+    auto onServe = [&early](const EventPtr& e) {
+      // the clock restarts at the deadline just served
+      early = early || std::chrono::steady_clock::now() < e->getEventClock().StartPoint();
+    };
+    for (int i = 0; i < 50; ++i) {
+      EventConfig config{0ms,     10ms + i * 100us, Event::kDefaultEndlessLifeMs, nullptr, onServe, nullptr, nullptr,
+                         nullptr};
+      config.slack = slack;
+      (void)scheduler.pushEvent(controller, userData, config);
+    }
+    runUntil(
+        scheduler,
+        []() {
+          return false;
+        },
+        200ms);
+    passes = scheduler.getPassCount();
+  };
+
+  std::uint64_t exactPasses = 0;
+  std::uint64_t coalescedPasses = 0;
+  bool early = false;
+  run(0ms, exactPasses, early);
+  run(10ms, coalescedPasses, early);
+  CHECK_FALSE(early);
+  CHECK(coalescedPasses < exactPasses);
+}
+
+TEST_CASE("Scheduler serves due events by priority and earliest deadline", "[scheduler][priority]") {
+  Scheduler scheduler;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+  std::vector<int> order;
+  auto push = [&](int id, Priority priority, DurationUnit delay) {
+    EventConfig config{delay,
+                       1h,
+                       2h,
+                       [&order, id](const EventPtr&) {
+                         order.push_back(id);
+                         // slow callbacks make the later events of a pass late
+                         std::this_thread::sleep_for(1ms);
+                       },
+                       nullptr,
+                       nullptr,
+                       nullptr,
+                       nullptr};
+    config.priority = priority;
+    (void)scheduler.pushEvent(controller, userData, config);
+  };
+  // pushed in the worst order: housekeeping first, latest deadlines first
+  for (int i = 0; i < 10; ++i) {
+    push(100 + i, Priority::Low, 1ms);
+  }
+  push(2, Priority::Critical, 3ms);
+  push(1, Priority::Critical, 2ms);
+  push(10, Priority::High, 1ms);
+
+  // start the delay clocks, then serve all events in one pass
+  (void)scheduler.processEvents(0ms);
+  std::this_thread::sleep_for(10ms);
+  (void)scheduler.processEvents(0ms);
+
+  REQUIRE(order.size() == 13);
+  CHECK(order[0] == 1);
+  CHECK(order[1] == 2);
+  CHECK(order[2] == 10);
+  CHECK(std::all_of(order.begin() + 3, order.end(), [](int id) {
+    return id >= 100;
+  }));
+
+  const auto critical = scheduler.getLateness(Priority::Critical);
+  const auto low = scheduler.getLateness(Priority::Low);
+  CHECK(critical.callbacks == 2);
+  CHECK(scheduler.getLateness(Priority::High).callbacks == 1);
+  CHECK(scheduler.getLateness(Priority::Normal).callbacks == 0);
+  CHECK(low.callbacks == 10);
+  CHECK(critical.max <= critical.total);
+  // the low events waited for the callbacks served before them
+  CHECK(low.max >= critical.max + 3ms);
+  CHECK(low.mean() > critical.mean());
+}
+
+TEST_CASE("LatencyHistogram reports percentiles within its bucket precision", "[histogram]") {
+  SECTION("buckets are contiguous and at most 1/32 of their values wide") {
+    for (std::size_t bucket = 1; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+      const auto lowest = LatencyHistogram::lowestValueOf(bucket);
+      REQUIRE(lowest == LatencyHistogram::lowestValueOf(bucket - 1) + LatencyHistogram::widthOf(bucket - 1));
+      REQUIRE(LatencyHistogram::bucketOf(lowest) == bucket);
+      REQUIRE(LatencyHistogram::bucketOf(lowest - 1) == bucket - 1);
+      REQUIRE(LatencyHistogram::widthOf(bucket) * 32 <= std::max<std::uint64_t>(lowest, 32));
+    }
+    CHECK(LatencyHistogram::bucketOf(LatencyHistogram::kMaxValue) == LatencyHistogram::kBucketCount - 1);
+  }
+
+  SECTION("percentiles of uniformly distributed values") {
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 100000; ++i) {
+      histogram.record(std::chrono::nanoseconds(i * 10));
+    }
+    histogram.record(-5ns);
+    const auto snapshot = histogram.snapshot();
+    CHECK(snapshot.count == 100001);
+    CHECK(snapshot.min == 0ns);
+    CHECK(snapshot.max == 1000000ns);
+    CHECK(std::abs(snapshot.p50().count() - 500000) <= 15000);
+    CHECK(std::abs(snapshot.p99().count() - 990000) <= 29700);
+    CHECK(std::abs(snapshot.p999().count() - 999000) <= 29970);
+    CHECK(snapshot.percentile(1.0) == snapshot.max);
+    CHECK(std::abs(snapshot.mean().count() - 500000) <= 500);
+
+    histogram.reset();
+    CHECK(histogram.snapshot().count == 0);
+    CHECK(histogram.snapshot().p99() == 0ns);
+  }
+
+  SECTION("concurrent recording loses no values") {
+    LatencyHistogram histogram;
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&histogram, t]() {
+        for (int i = 0; i < 10000; ++i) {
+          histogram.record(std::chrono::microseconds(t * 10000 + i));
+        }
+      });
+    }
+    threads.clear();
+    const auto snapshot = histogram.snapshot();
+    CHECK(snapshot.count == 40000);
+    CHECK(snapshot.max == 39999us);
+  }
+}
+
+TEST_CASE("Scheduler records callback timing histograms", "[scheduler][histogram]") {
+  Scheduler::Config config;
+  config.executionMode = GENERATE(Scheduler::ExecutionMode::Inline, Scheduler::ExecutionMode::Pool);
+  config.workerThreads = 2;
+  Scheduler scheduler(config);
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+  auto noop = [](const EventPtr&) {};
+  auto slowServe = [](const EventPtr&) {
+    std::this_thread::sleep_for(200us);
+  };
+  EventConfig traced{2ms, 1ms, Event::kDefaultEndlessLifeMs, noop, slowServe, nullptr, nullptr, nullptr};
+  traced.latencyHistograms = true;
+  auto tracedEvent = scheduler.pushEvent(controller, userData, traced);
+  auto plainEvent = scheduler.pushEvent(
+      controller, userData,
+      EventConfig{0ms, 1ms, Event::kDefaultEndlessLifeMs, nullptr, slowServe, nullptr, nullptr, nullptr});
+  REQUIRE(tracedEvent->getLatencyHistograms() != nullptr);
+  CHECK(plainEvent->getLatencyHistograms() == nullptr);
+
+  const auto& histograms = scheduler.getLatencyHistograms();
+  REQUIRE(scheduler.start());
+  const auto until = std::chrono::steady_clock::now() + 5s;
+  while (histograms.execution.snapshot().count < 20 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  // the snapshots are taken while the scheduler runs, lateness is recorded before the execution
+  const auto execution = histograms.execution.snapshot();
+  const auto lateness = histograms.lateness.snapshot();
+  CHECK(execution.count >= 20);
+  CHECK(lateness.count >= execution.count);
+  CHECK(execution.p50() >= 190us);
+  CHECK(lateness.p50() <= lateness.p99());
+  CHECK(lateness.p99() <= lateness.max);
+  // only the traced event has a start delay
+  CHECK(histograms.startDelay.snapshot().count == 1);
+
+  const auto& eventLatency = *tracedEvent->getLatencyHistograms();
+  CHECK(eventLatency.lateness.snapshot().count >= 1);
+  CHECK(eventLatency.lateness.snapshot().count < lateness.count);
+  CHECK(eventLatency.startDelay.snapshot().count == 1);
+  scheduler.terminate();
+}
+
+TEST_CASE("Scheduler replays virtual time on a manual clock", "[scheduler][clock]") {
+  struct Replay {
+    std::vector<std::chrono::nanoseconds> serves;  ///< Virtual times of the serve callbacks since the push
+    std::chrono::nanoseconds timeout{0};           ///< Virtual time of the timeout callback since the push
+    std::uint64_t periodicServes{0};               ///< Serve callbacks of the background events
+  };
+  /// Runs an event with a life of 8 s among 1000 periodic events for one virtual hour
+  auto replay = []() {
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler::Config config;
+    config.clock = clock;
+    Scheduler scheduler(config);
+    CHECK(&scheduler.getClock() == clock.get());
+    CHECK_FALSE(scheduler.start());
+
+    Replay result;
+    const auto pushed = clock->now();
+    auto since = [clock, pushed]() {
+      return clock->now() - pushed;
+    };
+    auto controller = std::make_shared<TestController>();
+    auto userData = std::make_shared<TestUserData>();
+    (void)scheduler.pushEvent(controller, userData,
+                              EventConfig{1s, 100ms, 8s, nullptr,
+                                          [&](EventPtr) {
+                                            result.serves.push_back(since());
+                                          },
+                                          nullptr, nullptr,
+                                          [&](EventPtr) {
+                                            result.timeout = since();
+                                          }});
+    for (int i = 0; i < 1000; ++i) {
+      (void)scheduler.pushEvent(controller, userData,
+                                EventConfig{std::chrono::milliseconds(i), 60s, 1h, nullptr,
+                                            [&](EventPtr) {
+                                              ++result.periodicServes;
+                                            },
+                                            nullptr, nullptr, nullptr});
+    }
+    // every wait jumps to the next deadline
+    while (scheduler.getEventsCount() > 0) {
+      clock->advance(scheduler.processEvents(1h));
+    }
+    CHECK(since() >= 1h);
+    CHECK(scheduler.getLatencyHistograms().lateness.snapshot().max == 0ns);
+    CHECK(scheduler.getMissedPeriods() == 0);
+    return result;
+  };
+
+  const auto wallStart = std::chrono::steady_clock::now();
+  const auto first = replay();
+  CHECK(std::chrono::steady_clock::now() - wallStart < 1h);
+  REQUIRE(first.serves.size() == 70);
+  CHECK(first.serves.front() == 1100ms);
+  CHECK(first.serves.back() == 8s);
+  CHECK(first.timeout == 8s);
+  // 59 periods after the start delays of 0 to 999 ms, a 60th only for the event whose life ends with it
+  CHECK(first.periodicServes == 1000 * 59 + 1);
+
+  // the same schedule yields the same callbacks at the same virtual times
+  const auto second = replay();
+  CHECK(second.serves == first.serves);
+  CHECK(second.timeout == first.timeout);
+  CHECK(second.periodicServes == first.periodicServes);
+}
+
+TEST_CASE("Cheap clocks follow steady_clock", "[scheduler][clock]") {
+  /// Reads the clock between two steady_clock reads for 50 ms, the clock may lag by tolerance
+  auto follows = [](const IClock& clock, std::chrono::nanoseconds tolerance) {
+    auto previous = clock.now();
+    std::size_t backwards = 0;
+    std::size_t outside = 0;
+    const auto end = std::chrono::steady_clock::now() + 50ms;
+    for (auto before = std::chrono::steady_clock::now(); before < end; before = std::chrono::steady_clock::now()) {
+      const auto time = clock.now();
+      const auto after = std::chrono::steady_clock::now();
+      backwards += time < previous ? 1 : 0;
+      outside += time < before - tolerance || time > after + tolerance ? 1 : 0;
+      previous = time;
+    }
+    CHECK(backwards == 0);
+    CHECK(outside == 0);
+  };
+  /// Serves an event with a period of 5 ms for 100 ms on the scheduler thread
+  auto serves = [](const std::shared_ptr<IClock>& clock, Scheduler::WaitStrategy waitStrategy) {
+    Scheduler::Config config;
+    config.clock = clock;
+    config.waitStrategy = waitStrategy;
+    Scheduler scheduler(config);
+    REQUIRE(scheduler.start());
+    std::atomic<int> count{0};
+    (void)scheduler.pushEvent(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                              EventConfig{0ms, 5ms, Event::kDefaultEndlessLifeMs, nullptr,
+                                          [&](EventPtr) {
+                                            ++count;
+                                          },
+                                          nullptr, nullptr, nullptr});
+    std::this_thread::sleep_for(100ms);
+    scheduler.terminate();
+    return count.load();
+  };
+
+  SECTION("coarse") {
+    const auto resolution = CoarseClock::resolution();
+    REQUIRE(resolution > 0ns);
+    const auto clock = std::make_shared<CoarseClock>();
+    CHECK(clock->isRealTime());
+    // a virtual machine may update the coarse time a tick late
+    follows(*clock, 2 * resolution + 5ms);
+    CHECK(serves(clock, Scheduler::WaitStrategy::Sleep) >= 5);
+  }
+  SECTION("tsc") {
+    const auto clock = TscClock::create();
+    if (!clock) {
+      WARN("no invariant time stamp counter");
+      return;
+    }
+    CHECK(clock->isRealTime());
+    CHECK(clock->getFrequency() > 1e8);
+    follows(*clock, 50us);
+    CHECK(serves(clock, Scheduler::WaitStrategy::Sleep) >= 5);
+#if defined(TEV_HAS_TSC)
+    // an origin 30 ms ahead of steady_clock and just past the re-anchor period
+    const auto ticksPerMilli = static_cast<std::int64_t>(clock->getFrequency() / 1000);
+    const auto nanos = [](std::chrono::steady_clock::time_point time) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    };
+    const auto ticks = static_cast<std::int64_t>(__rdtsc());
+    const auto steadyNow = std::chrono::steady_clock::now();
+    const TscClock ahead(
+        TscClock::Sample{static_cast<std::uint64_t>(ticks - 3000 * ticksPerMilli), nanos(steadyNow - 3s)},
+        TscClock::Sample{static_cast<std::uint64_t>(ticks - 1001 * ticksPerMilli), nanos(steadyNow - 1001ms + 30ms)});
+    // the re-anchor continues from the latest time the old origin could return, then meets steady_clock again
+    CHECK(ahead.now() - std::chrono::steady_clock::now() > 20ms);
+    follows(ahead, 35ms);
+#endif
+  }
+  SECTION("ahead of steady_clock") {
+    /// Real-time clock 200 ms ahead, a wait for its deadlines must not take them for steady_clock ones
+    struct AheadClock : IClock {
+      [[nodiscard]] TimePoint now() const noexcept override {
+        return std::chrono::steady_clock::now() + 200ms;
+      }
+      [[nodiscard]] bool isRealTime() const noexcept override {
+        return true;
+      }
+    };
+    const auto waitStrategy =
+        GENERATE(Scheduler::WaitStrategy::Sleep, Scheduler::WaitStrategy::SleepUntil,
+                 Scheduler::WaitStrategy::SleepThenSpin, Scheduler::WaitStrategy::BusyPoll,
+                 Scheduler::WaitStrategy::IoUring);
+    CHECK(serves(std::make_shared<AheadClock>(), waitStrategy) >= 5);
+  }
+}
+
+TEST_CASE("Scheduler counts passes, lifecycle transitions and lock times", "[scheduler][metrics]") {
+  Scheduler scheduler;
+  CallbackCounters counters;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+  auto otherUserData = std::make_shared<TestUserData>();
+
+  auto erased = std::make_shared<Event>(controller, userData, makeConfig(counters, 10s, 1s, 60s));
+  auto cancelled = std::make_shared<Event>(controller, userData, makeConfig(counters, 10s, 1s, 60s));
+  auto timedOut = std::make_shared<Event>(controller, otherUserData, makeConfig(counters, 0ms, 1ms, 5ms));
+  scheduler.pushEvent(erased);
+  const auto handle = scheduler.pushEvent(cancelled);
+  scheduler.pushEvent(timedOut);
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+  scheduler.eraseEvent(erased);
+  CHECK(scheduler.cancelEvent(handle));
+  runUntilEmpty(scheduler, 500ms);
+  REQUIRE(counters.timedOut == 1);
+  // erasing an event twice counts once
+  scheduler.eraseEvent(erased);
+  (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+
+  const auto metrics = scheduler.getMetrics();
+  CHECK(metrics.pushes == 3);
+  CHECK(metrics.erases == 1);
+  CHECK(metrics.cancels == 1);
+  CHECK(metrics.timedOut == 1);
+  CHECK(metrics.completed == 0);
+  CHECK(metrics.callbacks == static_cast<std::uint64_t>(counters.started + counters.served + counters.timedOut));
+  CHECK(metrics.passes == scheduler.getPassCount());
+  CHECK(metrics.idlePasses >= 1);
+  CHECK(metrics.idlePasses < metrics.passes);
+  CHECK(metrics.maxQueueDepth == 3);
+  CHECK(metrics.events == 0);
+  CHECK(metrics.pendingPushes == 0);
+  CHECK(metrics.lockHold > 0ns);
+  CHECK(metrics.lockHoldMax <= metrics.lockHold);
+
+  SECTION("Prometheus and JSON exports") {
+    const auto text = metrics.toPrometheus();
+    CHECK(text.find("# TYPE tev_scheduler_pushes_total counter\n") != std::string::npos);
+    CHECK(text.find("\ntev_scheduler_pushes_total 3\n") != std::string::npos);
+    CHECK(text.find("# TYPE tev_scheduler_events gauge\n") != std::string::npos);
+    CHECK(metrics.toPrometheus("shard0").find("\nshard0_cancels_total 1\n") != std::string::npos);
+    const auto json = metrics.toJson();
+    CHECK(json.front() == '{');
+    CHECK(json.find("\"pushes_total\":3,") != std::string::npos);
+    CHECK(json.find("\"timed_out_total\":1,") != std::string::npos);
+
+    const std::string path = "/tmp/tev_metrics_test.prom";
+    REQUIRE(metrics.writeFile(path, SchedulerMetrics::Format::Prometheus));
+    std::ifstream file(path);
+    const std::string written((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(written == text);
+    std::remove(path.c_str());
+    CHECK_FALSE(metrics.writeFile("/nonexistent/metrics.json", SchedulerMetrics::Format::Json));
+  }
+
+  SECTION("sums add up, maxima do not") {
+    auto sum = metrics;
+    sum += metrics;
+    CHECK(sum.pushes == 6);
+    CHECK(sum.lockHold == 2 * metrics.lockHold);
+    CHECK(sum.lockHoldMax == metrics.lockHoldMax);
+    CHECK(sum.maxQueueDepth == 3);
+  }
+}
+
+TEST_CASE("Scheduler counts the wake-ups of its thread", "[scheduler][metrics]") {
+  Scheduler scheduler;
+  CallbackCounters counters;
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+  REQUIRE(scheduler.start());
+  // the thread sleeps for the maximum interval, the push is due earlier
+  std::this_thread::sleep_for(20ms);
+  scheduler.pushEvent(std::make_shared<Event>(controller, userData, makeConfig(counters, 0ms, 1ms, 10ms)));
+  const auto until = std::chrono::steady_clock::now() + 5s;
+  while (counters.timedOut == 0 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  scheduler.terminate();
+  const auto metrics = scheduler.getMetrics();
+  CHECK(counters.timedOut == 1);
+  CHECK(metrics.pushWakeRequests >= 1);
+  CHECK(metrics.notifiedWakeUps >= 1);
+  CHECK(metrics.deadlineWakeUps >= 1);
+  CHECK(metrics.rearmWakeRequests == 0);
+}
+
+TEST_CASE("EventTracer keeps the latest records of every thread", "[trace]") {
+  EventTracer tracer(6);
+  CHECK(tracer.getCapacity() == 8);
+
+  SECTION("a full ring drops the oldest records") {
+    for (std::uint32_t i = 0; i < 20; ++i) {
+      tracer.callbackBegin(EventHandle{i, 1}, EventTracer::Callback::Serve);
+    }
+    tracer.status(EventHandle{7, 2}, Event::Status::Running, Event::Status::Aborted);
+    const auto traces = tracer.snapshot();
+    REQUIRE(traces.size() == 1);
+    CHECK(traces[0].dropped == 13);
+    REQUIRE(traces[0].records.size() == 8);
+    CHECK(traces[0].records.front().event == EventHandle{13, 1});
+    const auto& last = traces[0].records.back();
+    CHECK(last.kind == EventTracer::Kind::Status);
+    CHECK(last.event == EventHandle{7, 2});
+    CHECK(last.from == Event::Status::Running);
+    CHECK(last.to == Event::Status::Aborted);
+    CHECK(std::is_sorted(traces[0].records.begin(), traces[0].records.end(), [](const auto& a, const auto& b) {
+      return a.time < b.time;
+    }));
+  }
+
+  SECTION("every thread records into a ring of its own") {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&tracer, t]() {
+        tracer.nameThread("worker " + std::to_string(t));
+        for (int i = 0; i < 1000; ++i) {
+          tracer.sleep();
+          tracer.wake(i % 2 == 0);
+        }
+      });
+    }
+    // snapshots while the threads record see complete records only
+    for (int i = 0; i < 100; ++i) {
+      for (const auto& trace : tracer.snapshot()) {
+        for (const auto& record : trace.records) {
+          REQUIRE((record.kind == EventTracer::Kind::Sleep || record.kind == EventTracer::Kind::Wake));
+        }
+      }
+    }
+    threads.clear();
+    const auto traces = tracer.snapshot();
+    REQUIRE(traces.size() == 4);
+    for (const auto& trace : traces) {
+      CHECK(trace.name.starts_with("worker "));
+      CHECK(trace.records.size() == 8);
+      CHECK(trace.dropped == 1992);
+      CHECK(trace.records.back().kind == EventTracer::Kind::Wake);
+      CHECK_FALSE(trace.records.back().notified);
+    }
+  }
+
+  SECTION("records carry the time of the tracer clock") {
+    auto clock = std::make_shared<ManualClock>();
+    EventTracer manual(4, clock);
+    manual.sleep();
+    clock->advance(5ms);
+    manual.wake(true);
+    manual.callbackEnd(EventHandle{1, 1}, EventTracer::Callback::Serve, clock->now() + 1ms);
+    const auto traces = manual.snapshot();
+    REQUIRE(traces.size() == 1);
+    REQUIRE(traces[0].records.size() == 3);
+    CHECK(traces[0].records[0].time == ManualClock::kDefaultStart);
+    CHECK(traces[0].records[1].time == ManualClock::kDefaultStart + 5ms);
+    CHECK(traces[0].records[2].time == ManualClock::kDefaultStart + 6ms);
+  }
+}
+
+TEST_CASE("Scheduler traces lifecycles as a Chrome trace", "[scheduler][trace]") {
+  CHECK(Scheduler().getTracer() == nullptr);
+
+  Scheduler::Config config;
+  config.traceCapacity = 1024;
+  config.executionMode = GENERATE(Scheduler::ExecutionMode::Inline, Scheduler::ExecutionMode::Pool);
+  config.workerThreads = 1;
+  Scheduler scheduler(config);
+  REQUIRE(scheduler.getTracer() != nullptr);
+  CallbackCounters counters;
+  auto eventConfig = makeConfig(counters, 0ms, 1ms, 60s);
+  eventConfig.eventCallback = [&counters](EventPtr e) {
+    if (++counters.served == 3) {
+      e->setStatus(Event::Status::Completed);
+    }
+  };
+  auto event = std::make_shared<Event>(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                                       eventConfig);
+  const auto handle = scheduler.pushEvent(event);
+  REQUIRE(scheduler.start());
+  const auto until = std::chrono::steady_clock::now() + 5s;
+  while (counters.completed == 0 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  REQUIRE(counters.completed == 1);
+  // the complete callback may still be recording its end
+  std::this_thread::sleep_for(10ms);
+
+  std::vector<EventTracer::Record> records;
+  std::size_t wakes = 0;
+  for (const auto& trace : scheduler.getTracer()->snapshot()) {
+    records.insert(records.end(), trace.records.begin(), trace.records.end());
+    if (trace.name == "scheduler") {
+      wakes += static_cast<std::size_t>(std::count_if(trace.records.begin(), trace.records.end(), [](const auto& r) {
+        return r.kind == EventTracer::Kind::Wake;
+      }));
+    }
+  }
+  scheduler.terminate();
+  CHECK(wakes > 0);
+  const auto count = [&](EventTracer::Kind kind, EventTracer::Callback callback) {
+    return std::count_if(records.begin(), records.end(), [&](const auto& record) {
+      return record.kind == kind && record.callback == callback && record.event == handle;
+    });
+  };
+  CHECK(count(EventTracer::Kind::CallbackBegin, EventTracer::Callback::Start) == 1);
+  CHECK(count(EventTracer::Kind::CallbackBegin, EventTracer::Callback::Serve) == 3);
+  CHECK(count(EventTracer::Kind::CallbackEnd, EventTracer::Callback::Serve) == 3);
+  CHECK(count(EventTracer::Kind::CallbackEnd, EventTracer::Callback::Complete) == 1);
+  const auto transition = [&](Event::Status from, Event::Status to) {
+    return std::any_of(records.begin(), records.end(), [&](const auto& record) {
+      return record.kind == EventTracer::Kind::Status && record.from == from && record.to == to;
+    });
+  };
+  CHECK(transition(Event::Status::Pending, Event::Status::Running));
+  CHECK(transition(Event::Status::Running, Event::Status::Completed));
+
+  std::ostringstream json;
+  scheduler.getTracer()->writeChromeTrace(json);
+  const auto text = json.str();
+  CHECK(text.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+  CHECK(text.find("\"args\":{\"name\":\"scheduler\"}") != std::string::npos);
+  CHECK(text.find("{\"name\":\"serve\",\"cat\":\"callback\",\"ph\":\"B\"") != std::string::npos);
+  CHECK(text.find("{\"name\":\"Running->Completed\",\"cat\":\"status\",\"ph\":\"i\"") != std::string::npos);
+  CHECK(text.find("\"woken\":") != std::string::npos);
+  CHECK(text.ends_with("]}\n"));
+}
+
+TEST_CASE("ShardedScheduler places events by key and routes them to their shard", "[sharded]") {
+  CallbackCounters counters;
+  ShardedScheduler::Config config;
+  config.shards = 4;
+  config.cpus = {0};
+
+  SECTION("controller placement keeps the events of a controller together") {
+    ShardedScheduler scheduler(config);
+    REQUIRE(scheduler.getShardCount() == 4);
+    std::vector<EventPtr> events;
+    for (int c = 0; c < 8; ++c) {
+      auto controller = std::make_shared<TestController>();
+      auto userData = std::make_shared<TestUserData>();
+      const auto first = events.size();
+      for (int i = 0; i < 5; ++i) {
+        events.push_back(scheduler.pushEvent(controller, userData, makeConfig(counters, 0ms, 10ms, 1h)));
+      }
+      for (auto i = first; i < events.size(); ++i) {
+        CHECK(scheduler.findShard(*events[i]) == scheduler.findShard(*events[first]));
+      }
+    }
+    CHECK(scheduler.getEventsCount() == 40);
+
+    // a restart stays on the owning shard, erase and cancel are routed there
+    const auto handle = scheduler.pushEvent(events[0]);
+    CHECK(handle.shard == scheduler.findShard(*events[0]));
+    CHECK(EventHandleTable::tagOfHandle(handle.handle) == handle.shard);
+    CHECK(scheduler.cancelEvent(handle));
+    scheduler.eraseEvent(events[1]);
+    REQUIRE(scheduler.start());
+    const auto until = std::chrono::steady_clock::now() + 5s;
+    while ((scheduler.getEventsCount() != 38 || counters.served < 38) && std::chrono::steady_clock::now() < until) {
+      std::this_thread::sleep_for(1ms);
+    }
+    CHECK(scheduler.getEventsCount() == 38);
+    CHECK_FALSE(scheduler.getEventStatus(handle).has_value());
+    CHECK_FALSE(scheduler.findShard(*events[1]).has_value());
+    CHECK(counters.served >= 38);
+    scheduler.terminate();
+  }
+
+  SECTION("round robin spreads the events evenly") {
+    config.placement = ShardedScheduler::Placement::RoundRobin;
+    ShardedScheduler scheduler(config);
+    auto controller = std::make_shared<TestController>();
+    auto userData = std::make_shared<TestUserData>();
+    for (int i = 0; i < 8; ++i) {
+      (void)scheduler.pushEvent(controller, userData, makeConfig(counters, 1h, 1h, 2h));
+    }
+    for (std::size_t shard = 0; shard < scheduler.getShardCount(); ++shard) {
+      CHECK(scheduler.getShard(shard).getEventsCount() == 2);
+    }
+    scheduler.eraseEvent(std::static_pointer_cast<IUserData>(userData));
+    for (std::size_t shard = 0; shard < scheduler.getShardCount(); ++shard) {
+      (void)scheduler.getShard(shard).processEvents(0ms);
+    }
+    CHECK(scheduler.getEventsCount() == 0);
+  }
+
+  SECTION("a shard which cannot be pinned stops the shards started before") {
+    config.shards = 2;
+    config.cpus = {0, 1023};
+    ShardedScheduler scheduler(config);
+    CHECK_FALSE(scheduler.start());
+    // the first shard was stopped again, so it can be started on its own
+    CHECK(scheduler.getShard(0).start());
+    scheduler.getShard(0).stop();
+  }
+}
+
+TEST_CASE("IoUringWaiter waits for deadlines and wake-ups", "[ioUring]") {
+  auto waiter = IoUringWaiter::create();
+  if (!waiter) {
+    WARN("io_uring is not available, the IoUring wait strategy falls back to Sleep");
+    Scheduler::Config config;
+    config.waitStrategy = Scheduler::WaitStrategy::IoUring;
+    CHECK(Scheduler(config).getWaitStrategy() == Scheduler::WaitStrategy::Sleep);
+    return;
+  }
+  // deadlines never return early, also when they replace a pending one
+  for (const auto delay : {5ms, 1ms, 3ms}) {
+    const auto deadline = std::chrono::steady_clock::now() + delay;
+    CHECK_FALSE(waiter->waitUntil(deadline));
+    CHECK(std::chrono::steady_clock::now() >= deadline);
+  }
+  // a wake-up before the wait ends it at once
+  waiter->wake();
+  CHECK(waiter->waitUntil(std::chrono::steady_clock::now() + 10s));
+  // the wake-up is consumed, the next wait runs to its deadline
+  const auto next = std::chrono::steady_clock::now() + 2ms;
+  CHECK_FALSE(waiter->waitUntil(next));
+  CHECK(std::chrono::steady_clock::now() >= next);
+  // a wake-up from another thread ends a running wait
+  std::jthread waker([&waiter]() {
+    std::this_thread::sleep_for(5ms);
+    waiter->wake();
+  });
+  const auto start = std::chrono::steady_clock::now();
+  CHECK(waiter->waitUntil(start + 10s));
+  CHECK(std::chrono::steady_clock::now() - start < 5s);
+  // past deadlines return right away
+  CHECK_FALSE(waiter->waitUntil(start));
+  CHECK(waiter->getError() == 0);
+}
+
+#if defined(__linux__)
+TEST_CASE("Scheduler timerfd drives an external poll loop", "[scheduler][timerfd]") {
+  CallbackCounters counters;
+  Scheduler::Config config;
+  config.timerFd = true;
+  Scheduler scheduler(config);
+  const int fd = scheduler.getTimerFd();
+  REQUIRE(fd >= 0);
+  CHECK(Scheduler().getTimerFd() == -1);
+
+  auto readable = [fd](DurationUnit timeout) {
+    pollfd entry{fd, POLLIN, 0};
+    return ::poll(&entry, 1, static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count())) == 1;
+  };
+
+  // nothing scheduled, nothing to do
+  scheduler.processDue();
+  CHECK_FALSE(readable(20ms));
+
+  // a push makes the descriptor readable at once, the deadlines follow
+  auto event = scheduler.pushEvent(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                                   makeConfig(counters, 0ms, 5ms, Event::kDefaultEndlessLifeMs));
+  CHECK(readable(0ms));
+  int wakeups = 0;
+  while (counters.served < 3 && readable(1s)) {
+    scheduler.processDue();
+    ++wakeups;
+  }
+  CHECK(counters.started == 1);
+  CHECK(counters.served == 3);
+  // one wake-up for the push and one per deadline
+  CHECK(wakeups <= 1 + 3 + 1);
+
+  // an erase does not wake the loop, the pass at the next deadline applies it, afterwards the descriptor stays quiet
+  scheduler.eraseEvent(event);
+  REQUIRE(readable(1s));
+  scheduler.processDue();
+  CHECK(scheduler.getEventsCount() == 0);
+  CHECK_FALSE(readable(20ms));
+}
+
+TEST_CASE("Scheduler timerfd follows a clock offset from steady_clock", "[scheduler][timerfd][clock]") {
+  /// Real-time clock ahead of or behind steady_clock, the timerfd must not take its deadlines for steady ones
+  struct OffsetClock : IClock {
+    explicit OffsetClock(DurationUnit offset) : offset(offset) {}
+    [[nodiscard]] TimePoint now() const noexcept override {
+      return std::chrono::steady_clock::now() + offset;
+    }
+    [[nodiscard]] bool isRealTime() const noexcept override {
+      return true;
+    }
+    DurationUnit offset;
+  };
+  CallbackCounters counters;
+  Scheduler::Config config;
+  config.timerFd = true;
+  config.clock = std::make_shared<OffsetClock>(GENERATE(DurationUnit{200ms}, DurationUnit{-200ms}));
+  Scheduler scheduler(config);
+  const int fd = scheduler.getTimerFd();
+  REQUIRE(fd >= 0);
+  auto readable = [fd](DurationUnit timeout) {
+    pollfd entry{fd, POLLIN, 0};
+    return ::poll(&entry, 1, static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count())) == 1;
+  };
+
+  (void)scheduler.pushEvent(std::make_shared<TestController>(), std::make_shared<TestUserData>(),
+                            makeConfig(counters, 50ms, 50ms, Event::kDefaultEndlessLifeMs));
+  REQUIRE(readable(0ms));
+  scheduler.processDue();
+  // armed 50 ms ahead, neither at once nor 200 ms off
+  const auto armed = std::chrono::steady_clock::now();
+  CHECK_FALSE(readable(20ms));
+  REQUIRE(readable(150ms));
+  CHECK(std::chrono::steady_clock::now() - armed >= 40ms);
+  scheduler.processDue();
+  CHECK(counters.started == 1);
+}
+#endif
+
+TEST_CASE("WorkerPool runs every task once and steals work", "[pool]") {
+  std::atomic<int> executed{0};
+  std::mutex threadsMutex;
+  std::unordered_set<std::thread::id> threads;
+  {
+    WorkerPool pool(4);
+    CHECK(pool.getThreadCount() == 4);
+    CHECK_FALSE(pool.isWorkerThread());
+    for (int i = 0; i < 1000; ++i) {
+      pool.submit([&]() {
+        {
+          const std::lock_guard lg(threadsMutex);
+          threads.insert(std::this_thread::get_id());
+        }
+        ++executed;
+      });
+    }
+    // tasks submitted from a worker land on its own deque
+    pool.submit([&]() {
+      for (int i = 0; i < 100; ++i) {
+        pool.submit([&]() {
+          ++executed;
+        });
+      }
+    });
+  }
+  // destruction drains all queued tasks
+  CHECK(executed == 1100);
+  CHECK(threads.count(std::this_thread::get_id()) == 0);
+}
+
+TEST_CASE("Scheduler pool mode runs callbacks on worker threads", "[scheduler][pool]") {
+  Scheduler::Config config;
+  config.executionMode = Scheduler::ExecutionMode::Pool;
+  config.workerThreads = 2;
+  Scheduler scheduler(config);
+  REQUIRE(scheduler.getExecutionMode() == Scheduler::ExecutionMode::Pool);
+  auto controller = std::make_shared<TestController>();
+  auto userData = std::make_shared<TestUserData>();
+
+  SECTION("a slow callback blocks neither the pass nor other events") {
+    std::atomic<int> slowRunning{0};
+    std::atomic<int> slowOverlap{0};
+    std::atomic<int> fastServed{0};
+    CallbackCounters counters;
+    auto slowConfig = makeConfig(counters, 0ms, 5ms, 60s);
+    slowConfig.eventCallback = [&](EventPtr) {
+      if (++slowRunning > 1) {
+        ++slowOverlap;
+      }
+      std::this_thread::sleep_for(60ms);
+      --slowRunning;
+    };
+    auto fastConfig = makeConfig(counters, 0ms, 5ms, 60s);
+    fastConfig.eventCallback = [&](EventPtr e) {
+      // callbacks may use the scheduler, no lock is held while they run
+      if (++fastServed == 10) {
+        e->setStatus(Event::Status::Completed);
+      }
+    };
+    auto slow = scheduler.pushEvent(controller, userData, slowConfig);
+    auto fast = scheduler.pushEvent(controller, std::make_shared<TestUserData>(), fastConfig);
+    REQUIRE(scheduler.start());
+
+    const auto until = std::chrono::steady_clock::now() + 2s;
+    while (counters.completed == 0 && std::chrono::steady_clock::now() < until) {
+      std::this_thread::sleep_for(1ms);
+    }
+    const auto pass = std::chrono::steady_clock::now();
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(std::chrono::steady_clock::now() - pass < 30ms);
+    scheduler.eraseEvent(slow);
+    scheduler.terminate();
+
+    CHECK(counters.completed == 1);
+    CHECK(fastServed == 10);
+    CHECK(slowOverlap == 0);
+  }
+
+  SECTION("an event erased while in flight is not re-armed") {
+    std::atomic<bool> release{false};
+    CallbackCounters counters;
+    auto config = makeConfig(counters, 0ms, 1ms, 60s);
+    config.startCallback = [&](EventPtr) {
+      while (!release) {
+        std::this_thread::sleep_for(1ms);
+      }
+    };
+    auto event = scheduler.pushEvent(controller, userData, config);
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 1);
+    scheduler.eraseEvent(event);
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 0);
+    release = true;
+    std::this_thread::sleep_for(20ms);
+    (void)scheduler.processEvents(Scheduler::kMaxDelayIntervalMs);
+    CHECK(scheduler.getEventsCount() == 0);
+    CHECK(counters.served == 0);
+  }
+}
+
+TEST_CASE("Scheduler is destroyed while worker callbacks run", "[scheduler][pool]") {
+  Scheduler::Config config;
+  config.executionMode = GENERATE(Scheduler::ExecutionMode::Pool, Scheduler::ExecutionMode::Strand);
+  config.workerThreads = 2;
+  config.waitStrategy = Scheduler::WaitStrategy::IoUring;
+  config.timerFd = true;
+  std::atomic<int> served{0};
+  {
+    Scheduler scheduler(config);
+    CallbackCounters counters;
+    auto eventConfig = makeConfig(counters, 0ms, 1ms, 60s);
+    eventConfig.eventCallback = [&](EventPtr) {
+      ++served;
+      std::this_thread::sleep_for(2ms);
+    };
+    for (int i = 0; i < 8; ++i) {
+      (void)scheduler.pushEvent(std::make_shared<TestController>(), std::make_shared<TestUserData>(), eventConfig);
+    }
+    REQUIRE(scheduler.start());
+    const auto until = std::chrono::steady_clock::now() + 2s;
+    while (served < 8 && std::chrono::steady_clock::now() < until) {
+      std::this_thread::sleep_for(1ms);
+    }
+    // the callbacks still queued and running wake the scheduler when they return
+  }
+  CHECK(served >= 8);
+}
+
+TEST_CASE("StrandExecutor keeps the order per key", "[pool][strand]") {
+  std::array<int, 3> keys{};
+  std::array<std::vector<int>, 3> executed;
+  std::array<std::atomic<int>, 3> running{};
+  std::atomic<int> overlaps{0};
+  {
+    WorkerPool pool(4);
+    StrandExecutor strands(pool);
+    for (int i = 0; i < 300; ++i) {
+      const auto key = static_cast<std::size_t>(i % 3);
+      strands.post(&keys[key], [&, key, i]() {
+        if (++running[key] > 1) {
+          ++overlaps;
+        }
+        executed[key].push_back(i);
+        --running[key];
+      });
+    }
+  }
+  CHECK(overlaps == 0);
+  for (std::size_t key = 0; key < keys.size(); ++key) {
+    REQUIRE(executed[key].size() == 100);
+    CHECK(std::is_sorted(executed[key].begin(), executed[key].end()));
+  }
+}
+
+TEST_CASE("Scheduler strand mode serializes callbacks per controller", "[scheduler][strand]") {
+  Scheduler::Config config;
+  config.executionMode = Scheduler::ExecutionMode::Strand;
+  config.workerThreads = 4;
+  Scheduler scheduler(config);
+
+  /// Controller which detects concurrent use of its state
+  struct CheckedController : public IController {
+    std::atomic<int> running{0};
+    std::atomic<int> overlaps{0};
+    std::atomic<int> served{0};
+  };
+  std::array<std::shared_ptr<CheckedController>, 2> controllers{std::make_shared<CheckedController>(),
+                                                                std::make_shared<CheckedController>()};
+  std::atomic<int> active{0};
+  std::atomic<int> parallel{0};
+  CallbackCounters counters;
+  auto config2 = makeConfig(counters, 0ms, 2ms, 300ms);
+  config2.eventCallback = [&](EventPtr e) {
+    auto& controller = static_cast<CheckedController&>(*e->getController());
+    if (++controller.running > 1) {
+      ++controller.overlaps;
+    }
+    if (++active > 1) {
+      ++parallel;
+    }
+    std::this_thread::sleep_for(3ms);
+    --active;
+    ++controller.served;
+    --controller.running;
+  };
+  for (int i = 0; i < 8; ++i) {
+    auto event =
+        scheduler.pushEvent(controllers[static_cast<std::size_t>(i % 2)], std::make_shared<TestUserData>(), config2);
+  }
+  REQUIRE(scheduler.start());
+  const auto until = std::chrono::steady_clock::now() + 3s;
+  while (counters.timedOut < 8 && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(5ms);
+  }
+  scheduler.terminate();
+
+  CHECK(counters.timedOut == 8);
+  for (const auto& controller : controllers) {
+    CHECK(controller->served > 0);
+    CHECK(controller->overlaps == 0);
+  }
+  // callbacks of different controllers do run in parallel
+  CHECK(parallel > 0);
+}